@@ -0,0 +1,165 @@
+#include "globals.h"
+#include "image.h"
+#include "integrator.h"
+#include "job.h"
+#include "render_status.h"
+#include "scene.h"
+#include "scene_parser.h"
+#include "tile_scheduler.h"
+#include "work_queue.h"
+
+#include <embree3/rtcore.h>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#define TINYEXR_IMPLEMENTATION
+#include "tinyexr.h"
+
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+Job *g_job;
+RTCDevice g_rtcDevice;
+RTCScene g_rtcScene;
+
+// Claims tile ranges from the output directory's work queue until none are
+// left. Each range renders as its own job under parts/, with its own seed so
+// integrators that ignore the range still produce independent estimates;
+// pathed_merge sums the parts.
+static void renderWorkItems(Integrator &integrator, Image &image, Scene &scene)
+{
+    const std::string partsDirectory = g_job->outputDirectory() + "parts/";
+    mkdir(partsDirectory.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+
+    char hostname[256] = "localhost";
+    gethostname(hostname, sizeof(hostname) - 1);
+    const std::string workerName = std::string(hostname) + ":" + std::to_string(getpid());
+
+    const int rangeCount = g_job->distributedRanges();
+    WorkQueue queue(g_job->outputDirectory() + "queue");
+    if (!queue.create(rangeCount, g_job->checkpointHash(), workerName)) {
+        throw std::runtime_error("Failed to create work queue");
+    }
+    if (queue.doneCount() == rangeCount) {
+        throw std::runtime_error(
+            "Every work item is already done, remove "
+            + g_job->outputDirectory() + "queue to render again"
+        );
+    }
+
+    const int tileCount = TileScheduler(g_job->cropWindow(), g_job->tileSize()).tileCount();
+
+    const uint64_t baseSeed = g_job->seed();
+
+    auto callback = [](RenderStatus renderStatus) {};
+    bool quit = false;
+
+    int item;
+    while (queue.claim(workerName, &item)) {
+        const int tileBegin = (int64_t)tileCount * item / rangeCount;
+        const int tileEnd = (int64_t)tileCount * (item + 1) / rangeCount;
+
+        std::ostringstream stemStream;
+        stemStream << "parts/part_" << std::setfill('0') << std::setw(5) << item;
+
+        std::cout << "Rendering " << stemStream.str()
+                  << " (tiles " << tileBegin << "-" << tileEnd << ")" << std::endl;
+
+        g_job->setTileRange(tileBegin, tileEnd);
+        g_job->setOutputStem(stemStream.str());
+        g_job->setCheckpointName(stemStream.str() + ".ckpt");
+        g_job->restoreSeed(baseSeed + item);
+
+        integrator.run(image, scene, callback, &quit);
+
+        queue.complete(item);
+    }
+}
+
+// Renders a job straight to its output directory without touching
+// NanoGUI, GLFW or OpenGL. Progress goes to stdout; a non-zero exit code
+// means the frame was not rendered.
+int main(int argc, char *argv[]) {
+    g_rtcDevice = rtcNewDevice(NULL);
+    if (g_rtcDevice == NULL) {
+        std::cerr << "Failed to create device" << std::endl;
+        return 1;
+    }
+
+    g_rtcScene = rtcNewScene(g_rtcDevice);
+    if (g_rtcScene == NULL) {
+        std::cerr << "Failed to create scene" << std::endl;
+        return 1;
+    }
+
+    if (chdir("..") != 0) {
+        std::cerr << "Failed to change to the project directory" << std::endl;
+        return 1;
+    }
+
+    std::string jobPath = "job.json";
+    bool resume = false;
+    bool worker = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--resume") {
+            resume = true;
+        } else if (std::string(argv[i]) == "--worker") {
+            worker = true;
+        } else {
+            jobPath = argv[i];
+        }
+    }
+    std::cout << "Using: " << jobPath << std::endl;
+
+    try {
+        std::ifstream jsonJob(jobPath);
+        if (!jsonJob) {
+            std::cerr << "Failed to open job: " << jobPath << std::endl;
+            return 1;
+        }
+
+        g_job = new Job(jsonJob);
+        // Workers share one output directory, and pick up their own part
+        // checkpoints if restarted
+        g_job->setResume(resume || worker);
+        g_job->init();
+
+        Image image(g_job->width(), g_job->height());
+
+        std::ifstream jsonScene(g_job->scene());
+        if (!jsonScene) {
+            std::cerr << "Failed to open scene: " << g_job->scene() << std::endl;
+            return 1;
+        }
+        Scene scene = parseScene(jsonScene);
+
+        std::shared_ptr<Integrator> integrator = g_job->integrator();
+
+        // Integrator::run logs each pass, nothing listens for render status
+        auto callback = [](RenderStatus renderStatus) {};
+        bool quit = false;
+
+        if (worker) {
+            renderWorkItems(*integrator, image, scene);
+        } else {
+            integrator->run(image, scene, callback, &quit);
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Render failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    rtcReleaseScene(g_rtcScene);
+    rtcReleaseDevice(g_rtcDevice);
+
+    return 0;
+}
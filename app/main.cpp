@@ -20,6 +20,7 @@
 
 #include <assert.h>
 #include <memory>
+#include <string>
 #include <thread>
 #include <unistd.h>
 #include <vector>
@@ -60,16 +61,21 @@ int main(int argc, char *argv[]) {
     int success = chdir("..");
     assert(success == 0);
 
-    if (argc > 1) {
-        printf("Using: %s\n", argv[1]);
-
-        ifstream jsonJob(argv[1]);
-        g_job = new Job(jsonJob);
-    } else {
-        ifstream jsonJob("job.json");
-        g_job = new Job(jsonJob);
+    std::string jobPath = "job.json";
+    bool resume = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--resume") {
+            resume = true;
+        } else {
+            jobPath = argv[i];
+            printf("Using: %s\n", argv[i]);
+        }
     }
 
+    ifstream jsonJob(jobPath);
+    g_job = new Job(jsonJob);
+    g_job->setResume(resume);
+
     g_job->init();
 
     const int width = g_job->width();
@@ -81,6 +87,18 @@ int main(int argc, char *argv[]) {
 
     std::shared_ptr<Integrator> integrator = g_job->integrator();
 
+    // Without a UI there's nothing for the main thread to do, and no reason
+    // to bring up GLFW; pathed_headless skips linking it entirely
+    if (!g_job->showUI()) {
+        bool quit = false;
+        run(integrator, image, scene, [](RenderStatus renderStatus) {}, &quit);
+
+        rtcReleaseScene(g_rtcScene);
+        rtcReleaseDevice(g_rtcDevice);
+
+        return 0;
+    }
+
     nanogui::init();
     nanogui::ref<PathedScreen> screen = new PathedScreen(
         integrator,
@@ -98,15 +116,13 @@ int main(int argc, char *argv[]) {
     std::thread renderThread(run, integrator, std::ref(image), std::ref(scene), callback, &quit);
 
     try {
-       if (g_job->showUI()) {
-            screen->drawAll();
-            screen->setVisible(true);
+        screen->drawAll();
+        screen->setVisible(true);
 
-            nanogui::mainloop();
+        nanogui::mainloop();
 
-            nanogui::shutdown();
-            quit = true;
-        }
+        nanogui::shutdown();
+        quit = true;
     } catch (const std::runtime_error &e) {
         std::string error_msg = std::string("Caught a fatal error: ") + std::string(e.what());
         #if defined(_WIN32)
@@ -0,0 +1,119 @@
+#include "accumulator.h"
+#include "globals.h"
+#include "image.h"
+#include "job.h"
+
+#include <embree3/rtcore.h>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#define TINYEXR_IMPLEMENTATION
+#include "tinyexr.h"
+
+#include <algorithm>
+#include <dirent.h>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+Job *g_job;
+RTCDevice g_rtcDevice;
+RTCScene g_rtcScene;
+
+static std::vector<std::string> listCheckpoints(const std::string &directory)
+{
+    std::vector<std::string> paths;
+
+    DIR *dir = opendir(directory.c_str());
+    if (dir == nullptr) { return paths; }
+
+    while (struct dirent *entry = readdir(dir)) {
+        const std::string name = entry->d_name;
+        const std::string extension = ".ckpt";
+        if (name.size() > extension.size()
+            && name.compare(name.size() - extension.size(), extension.size(), extension) == 0
+        ) {
+            paths.push_back(directory + name);
+        }
+    }
+    closedir(dir);
+
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+// Combines the part checkpoints written by pathed_headless --worker into the
+// job's final EXR, weighting every pixel by the samples each part took
+int main(int argc, char *argv[]) {
+    if (chdir("..") != 0) {
+        std::cerr << "Failed to change to the project directory" << std::endl;
+        return 1;
+    }
+
+    const std::string jobPath = argc > 1 ? argv[1] : "job.json";
+    std::cout << "Using: " << jobPath << std::endl;
+
+    try {
+        std::ifstream jsonJob(jobPath);
+        if (!jsonJob) {
+            std::cerr << "Failed to open job: " << jobPath << std::endl;
+            return 1;
+        }
+        g_job = new Job(jsonJob);
+
+        const int width = g_job->width();
+        const int height = g_job->height();
+        const uint64_t checkpointHash = g_job->checkpointHash();
+
+        Accumulator merged(width, height);
+        int partCount = 0;
+
+        for (const std::string &path : listCheckpoints(g_job->outputDirectory() + "parts/")) {
+            Accumulator part(width, height);
+            CheckpointInfo info;
+            if (!part.loadCheckpoint(path, checkpointHash, &info)) {
+                std::cerr << "Skipping " << path << ": not a checkpoint of this job" << std::endl;
+                continue;
+            }
+
+            merged.merge(part);
+            partCount += 1;
+        }
+
+        if (partCount == 0) {
+            std::cerr << "No parts to merge" << std::endl;
+            return 1;
+        }
+
+        int maxSamples = 0;
+        Image image(width, height);
+        if (!g_job->cropComposite().empty() && !image.load(g_job->cropComposite())) {
+            std::cerr << "Failed to composite onto " << g_job->cropComposite() << std::endl;
+        }
+
+        const Tile cropWindow = g_job->cropWindow();
+        for (int row = cropWindow.startRow; row < cropWindow.endRow; row++) {
+            for (int col = cropWindow.startCol; col < cropWindow.endCol; col++) {
+                const int pixelIndex = row * width + col;
+                const Color mean = merged.mean(pixelIndex);
+
+                image.set(row, col, mean.r(), mean.g(), mean.b());
+                maxSamples = std::max(maxSamples, merged.sampleCount(pixelIndex));
+            }
+        }
+        image.setSpp(maxSamples);
+        image.save(g_job->outputStem());
+
+        std::cout << "Merged " << partCount << " parts, "
+                  << merged.totalSamples() << " samples" << std::endl;
+    } catch (const std::exception &e) {
+        std::cerr << "Merge failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
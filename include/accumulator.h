@@ -0,0 +1,81 @@
+#pragma once
+
+#include "color.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Identifies what a checkpoint belongs to and how far it got
+struct CheckpointInfo {
+    uint64_t jobHash;
+    uint64_t seed;
+    int passes;
+};
+
+// Per-pixel radiance sums with a running luminance variance (Welford), so
+// passes can skip pixels whose estimate has already converged.
+//
+// Sample integrators add one estimate per pixel per pass. Splatting
+// integrators add to arbitrary pixels and count the pass once it is done.
+class Accumulator {
+public:
+    Accumulator(int width, int height);
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    int pixelCount() const { return m_width * m_height; }
+
+    void add(int pixelIndex, const Color &color);
+
+    void splat(int pixelIndex, const Color &color);
+    void addSplatPass();
+
+    int sampleCount(int pixelIndex) const { return m_sampleCounts[pixelIndex]; }
+    uint64_t totalSamples() const;
+
+    Color mean(int pixelIndex) const;
+    float relativeError(int pixelIndex) const;
+
+    // Luminance variance of the pixel's mean. With fewer than two samples
+    // it is unknown, and the squared mean luminance stands in.
+    float meanVariance(int pixelIndex) const;
+
+    bool isActive(int pixelIndex) const { return m_active[pixelIndex]; }
+    int activeCount() const { return m_activeCount; }
+
+    // Retires every pixel whose relative error is below threshold after at
+    // least minSamples; returns how many pixels are still active
+    int updateConvergence(float threshold, int minSamples);
+
+    // Folds in another render of the same frame, e.g. from another process.
+    // Sums and counts add; luminance variance combines per Chan et al.
+    void merge(const Accumulator &other);
+
+    // Leave a pixel out of every later pass
+    void deactivate(int pixelIndex);
+
+    // Raw sums, counts, variance and convergence state in a versioned binary
+    // file. Writes go to a temporary file renamed over path, so a render
+    // killed mid-write leaves the previous checkpoint intact.
+    bool saveCheckpoint(const std::string &path, const CheckpointInfo &info) const;
+
+    // Leaves the accumulator untouched unless the file is complete, matches
+    // this accumulator's size and was written for expectedJobHash
+    bool loadCheckpoint(
+        const std::string &path,
+        uint64_t expectedJobHash,
+        CheckpointInfo *info
+    );
+
+private:
+    int m_width, m_height;
+
+    std::vector<float> m_radiance;
+    std::vector<float> m_luminanceMean;
+    std::vector<float> m_luminanceM2;
+    std::vector<int> m_sampleCounts;
+
+    std::vector<uint8_t> m_active;
+    int m_activeCount;
+};
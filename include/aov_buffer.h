@@ -0,0 +1,45 @@
+#pragma once
+
+#include "color.h"
+#include "image.h"
+#include "intersection.h"
+#include "surface.h"
+#include "types.h"
+#include "vector.h"
+
+#include <unordered_map>
+#include <vector>
+
+// First-hit auxiliary outputs for compositing and denoising. Albedo and
+// shading normal average over every camera ray through a pixel, depth over
+// the rays that hit something. The material ID is that of the first hit.
+class AOVBuffer {
+public:
+    AOVBuffer(int width, int height);
+
+    // Numbers materials in scene order, so IDs are stable between renders
+    void assignMaterialIDs(const NestedSurfaceVector &surfaces);
+
+    // Pixels must only be added to by one thread at a time
+    void add(int pixelIndex, const Intersection &intersection);
+
+    Color albedo(int pixelIndex) const;
+    Vector3 normal(int pixelIndex) const;
+    float depth(int pixelIndex) const;
+    int materialID(int pixelIndex) const { return m_materialIDs[pixelIndex]; }
+
+    // Adds every buffer to image as extra EXR channels
+    void write(Image &image) const;
+
+private:
+    int m_width, m_height;
+
+    std::vector<float> m_albedo;
+    std::vector<float> m_normal;
+    std::vector<float> m_depth;
+    std::vector<int> m_materialIDs;
+    std::vector<int> m_rayCounts;
+    std::vector<int> m_hitCounts;
+
+    std::unordered_map<const Material *, int> m_materialTable;
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "sampler.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Blue-noise dithered sampling (Georgiev and Fajardo 2016). All pixels share
+// one Owen-scrambled Sobol sequence and each pixel rotates it by a value read
+// from a tiled blue-noise mask, so the error left at low sample counts is
+// pushed to high frequencies instead of clumping.
+class BlueNoiseSampler : public Sampler {
+public:
+    BlueNoiseSampler(uint64_t seed, int width);
+
+    float next() override;
+    std::array<float, 2> next2D() override;
+
+    static const int MaskSize = 64;
+    static const std::vector<float> &mask();
+
+private:
+    float offset(int dimension) const;
+
+    int m_width;
+    uint32_t m_sequenceSeed;
+};
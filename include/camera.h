@@ -4,6 +4,7 @@
 #include "transform.h"
 #include "vector.h"
 
+class RandomGenerator;
 class Ray;
 
 struct Pixel {
@@ -33,7 +34,7 @@ public:
     Resolution getResolution() const { return m_resolution; }
 
     Ray generateRay(float row, float col) const;
-    Ray generateRay(int row, int col) const;
+    Ray generateRay(int row, int col, RandomGenerator &random) const;
 
     void calculatePixel(const Point3 &point, Pixel *pixel) const;
 private:
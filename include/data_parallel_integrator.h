@@ -1,5 +1,6 @@
 #pragma once
 
+#include "accumulator.h"
 #include "bounce_controller.h"
 #include "integrator.h"
 #include "intersection.h"
@@ -18,10 +19,11 @@ public:
 
 protected:
     void sampleImage(
-        std::vector<float> &radianceLookup,
-        std::vector<Sample> &sampleLookup,
+        Accumulator &accumulator,
+        SampleLookup &sampleLookup,
         Scene &scene,
-        RandomGenerator &random
+        RandomGenerator &random,
+        int sampleIndex
     ) override;
 
     void preprocess(const Scene &scene, RandomGenerator &random) override;
@@ -38,6 +40,7 @@ private:
     void generateInitialIntersections(
         int rows, int cols,
         const Scene &scene,
+        RandomGenerator &random,
         std::vector<Intersection> &intersections
     );
 
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "accumulator.h"
+#include "aov_buffer.h"
+#include "color.h"
+#include "vector.h"
+
+#include <vector>
+
+// Edge-avoiding à-trous wavelet filter after Dammertz et al., "Edge-Avoiding
+// À-Trous Wavelet Transform for fast Global Illumination Filtering" (2010),
+// with the variance-guided luminance weight of SVGF (Schied et al. 2017).
+// Radiance is divided by albedo while filtering so texture survives.
+class Denoiser {
+public:
+    Denoiser(int width, int height, int iterations);
+
+    void setPixel(
+        int pixelIndex,
+        const Color &radiance,
+        float variance,
+        const Color &albedo,
+        const Vector3 &normal,
+        float depth
+    );
+
+    // Every pixel's mean and variance from accumulator, features from aovs
+    void setInput(const Accumulator &accumulator, const AOVBuffer &aovs);
+
+    void denoise();
+
+    Color output(int pixelIndex) const;
+
+private:
+    void filterPass(int step);
+
+    int m_width, m_height;
+    int m_iterations;
+
+    // Demodulated radiance and its luminance variance, ping-ponged between
+    // passes
+    std::vector<Color> m_radiance;
+    std::vector<Color> m_filtered;
+    std::vector<float> m_variance;
+    std::vector<float> m_filteredVariance;
+
+    std::vector<Color> m_albedo;
+    std::vector<Vector3> m_normal;
+    std::vector<float> m_depth;
+};
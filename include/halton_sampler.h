@@ -0,0 +1,22 @@
+#pragma once
+
+#include "sampler.h"
+
+#include <cstdint>
+
+// Halton points with per-pixel random digit scrambling. Dimensions past the
+// prime table fall back to the pixel's independent stream.
+class HaltonSampler : public Sampler {
+public:
+    HaltonSampler(uint64_t seed);
+
+    void startPixelSample(int pixelIndex, int sampleIndex) override;
+
+    float next() override;
+
+protected:
+    uint64_t streamPosition(int dimension) const override;
+
+private:
+    uint32_t m_pixelSeed;
+};
@@ -1,9 +1,24 @@
 #pragma once
 
-#include <mutex>
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
+// Immutable copy of an image's float data, shared by the display, the EXR
+// writer and anything else reading the render while it carries on
+struct ImageSnapshot {
+    int width, height;
+    int spp;
+
+    // Interleaved RGB, bottom row first as EXR expects
+    std::vector<float> raw;
+    std::map<std::string, std::vector<float> > channels;
+};
+
+// Double-buffered: one thread sets pixels in a private back buffer and
+// publishes it by swapping in a new snapshot pointer. Readers grab the
+// latest snapshot without a lock, and keep it alive as long as they hold it.
 class Image {
 public:
     Image(int width, int height);
@@ -11,15 +26,32 @@ public:
     void set(int row, int col, float r, float g, float b);
     void debug();
 
+    // Publishes, then writes synchronously; ImageWriter takes snapshots off
+    // the render thread
     void save(const std::string &filestem);
     void saveCheckpoint(const std::string &filestem);
 
+    // 8-bit BMP, publishes first
     void write(const std::string &filename);
 
-    const std::vector<unsigned char> &data();
-    std::mutex &getLock();
+    // Replaces the image with an EXR of the same size
+    bool load(const std::string &path);
+
+    // Makes everything set so far visible to readers
+    void publish();
+
+    // Latest published frame, safe from any thread
+    std::shared_ptr<const ImageSnapshot> snapshot() const;
 
-    void setSpp(int spp) { m_spp = spp; }
+    // Gamma-corrected 8-bit RGB of the latest published frame, top row
+    // first. Converted on each call; renders that never display skip it.
+    std::vector<unsigned char> data() const;
+
+    void setSpp(int spp) { m_back->spp = spp; }
+
+    // Extra full-precision EXR channel saved next to RGB, one value per
+    // pixel in row * width + col order
+    void setChannel(const std::string &name, const std::vector<float> &values);
 
 private:
     void save(const std::string &filestem, bool saveCheckpoint);
@@ -27,8 +59,10 @@ private:
     std::string pathFromFilename(const std::string &filename);
 
     int m_height, m_width;
-    int m_spp;
-    std::vector<unsigned char> m_data;
-    std::vector<float> m_raw;
-    std::mutex m_lock;
+
+    // Only touched by the thread setting pixels
+    std::shared_ptr<ImageSnapshot> m_back;
+
+    // Swapped with std::atomic_load/atomic_store
+    std::shared_ptr<const ImageSnapshot> m_front;
 };
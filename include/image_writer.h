@@ -0,0 +1,68 @@
+#pragma once
+
+#include "image.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Writes image snapshots to EXR on a background thread so the render loop
+// doesn't wait on encoding or disk. The queue is bounded: once capacity
+// snapshots are waiting, save() blocks rather than piling up frame copies.
+class ImageWriter {
+public:
+    // Files go under directory, which ends in a slash. compression is a
+    // TINYEXR_COMPRESSIONTYPE_* value.
+    ImageWriter(const std::string &directory, int capacity, int compression);
+
+    // Finishes every queued write
+    ~ImageWriter();
+
+    ImageWriter(const ImageWriter &) = delete;
+    ImageWriter &operator=(const ImageWriter &) = delete;
+
+    // Queues <filestem>.exr, plus the <filestem>-NNNNNspp.exr copy for
+    // checkpoints
+    void save(
+        std::shared_ptr<const ImageSnapshot> snapshot,
+        const std::string &filestem,
+        bool checkpoint
+    );
+
+    // Blocks until everything queued so far is on disk
+    void flush();
+
+    // The synchronous write behind both; pathStem includes the directory.
+    // Each file is written next to its destination and renamed over it, so
+    // readers never see a partial EXR.
+    static bool write(
+        const ImageSnapshot &snapshot,
+        const std::string &pathStem,
+        bool checkpoint,
+        int compression
+    );
+
+private:
+    struct Request {
+        std::shared_ptr<const ImageSnapshot> snapshot;
+        std::string filestem;
+        bool checkpoint;
+    };
+
+    void drain();
+
+    std::string m_directory;
+    int m_capacity;
+    int m_compression;
+
+    std::deque<Request> m_queue;
+    bool m_writing;
+    bool m_stopping;
+
+    std::mutex m_lock;
+    std::condition_variable m_changed;
+    std::thread m_thread;
+};
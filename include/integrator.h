@@ -1,5 +1,7 @@
 #pragma once
 
+#include "accumulator.h"
+#include "aov_buffer.h"
 #include "color.h"
 #include "image.h"
 #include "intersection.h"
@@ -11,6 +13,9 @@
 #include "render_status.h"
 
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <vector>
 
 class Integrator {
@@ -28,6 +33,10 @@ public:
 
     void helloWorld() { printf("HELLO WORLD\n"); }
 
+    // Record the paths through this pixel for the debug UI, starting with
+    // the next pass
+    void captureSamples(int pixelIndex);
+
     virtual std::vector<float> visualizePDF(
         int rows, int cols,
         int row, int col,
@@ -35,6 +44,12 @@ public:
     ) {};
 
 protected:
+    SampleLookup emptySampleLookup();
+
+    // Null unless the job asks for AOVs; integrators with camera rays add
+    // their first hits
+    AOVBuffer *aovBuffer() { return m_aovBuffer.get(); }
+
     //temp!! for real
     virtual std::vector<DataSource::Point> getPhotons() const {
         std::vector<DataSource::Point> dummy;
@@ -46,10 +61,21 @@ protected:
         return dummy;
     };
 
+    // Sample integrators estimate each pixel independently and can skip
+    // converged pixels
+    virtual bool adaptiveSampling() const { return false; }
+
     virtual void sampleImage(
-        std::vector<float> &radianceLookup,
-        std::vector<Sample> &sampleLookup,
+        Accumulator &accumulator,
+        SampleLookup &sampleLookup,
         Scene &scene,
-        RandomGenerator &random
+        RandomGenerator &random,
+        int sampleIndex
     ) {};
+
+private:
+    std::unique_ptr<AOVBuffer> m_aovBuffer;
+
+    std::mutex m_captureLock;
+    std::set<int> m_capturedPixels;
 };
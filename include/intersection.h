@@ -2,7 +2,7 @@
 
 #include "material.h"
 #include "point.h"
-#include "transform.h"
+#include "shading_frame.h"
 #include "uv.h"
 #include "vector.h"
 
@@ -19,10 +19,7 @@ struct Intersection {
     Vector3 shadingNormal;
     UV uv;
     Material *material;
-    Surface *surface;
-
-    Transform tangentToWorld;
-    Transform worldToTangent;
+    const Surface *surface;
 
     Intersection(
         bool hit_,
@@ -33,7 +30,7 @@ struct Intersection {
         Vector3 shadingNormal_,
         UV uv_,
         Material *material_,
-        Surface *surface_
+        const Surface *surface_
     ) : hit(hit_),
         t(t_),
         point(point_),
@@ -42,17 +39,29 @@ struct Intersection {
         shadingNormal(shadingNormal_),
         uv(uv_),
         material(material_),
-        surface(surface_)
-    {
-        if (hit) {
-            tangentToWorld = normalToWorldSpace(shadingNormal, woWorld);
-            worldToTangent = worldSpaceToNormal(shadingNormal, woWorld);
+        surface(surface_),
+        m_hasFrame(false)
+    {}
+
+    // Shading frame around shadingNormal, built the first time a BSDF or
+    // integrator asks for it. Hits that only test visibility or emission
+    // never pay for it. The first call writes the cache, so make it before
+    // sharing one Intersection across threads.
+    const ShadingFrame &frame() const {
+        if (!m_hasFrame) {
+            m_frame = ShadingFrame(shadingNormal, woWorld);
+            m_hasFrame = true;
         }
+        return m_frame;
     }
 
     bool isEmitter() const {
         return !(material->emit().isBlack());
     }
+
+private:
+    mutable bool m_hasFrame;
+    mutable ShadingFrame m_frame;
 };
 
 namespace IntersectionHelper {
@@ -2,19 +2,52 @@
 
 #include "bounce_controller.h"
 #include "integrator.h"
+#include "russian_roulette.h"
+#include "sampler.h"
+#include "tile_scheduler.h"
 
 #include "json.hpp"
 
+#include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <vector>
 
 class Job {
 public:
     Job(std::ifstream &jobFile);
     void init();
 
+    // Continue from the accumulator checkpoint in an existing output
+    // directory (--resume)
+    bool resume() const { return m_resume; }
+    void setResume(bool resume) { m_resume = resume; }
+
+    std::string checkpointPath() const { return outputDirectory() + m_checkpointName; }
+    void setCheckpointName(const std::string &name) { m_checkpointName = name; }
+
+    // Filestem for the EXRs Integrator::run saves
+    std::string outputStem() const { return m_outputStem; }
+    void setOutputStem(const std::string &stem) { m_outputStem = stem; }
+
+    // Restricts rendering to Morton tiles [begin, end) for distributed
+    // workers; by default the whole frame is rendered
+    void setTileRange(int begin, int end);
+    bool hasTileRange() const { return m_tileRangeEnd >= 0; }
+    int tileRangeBegin() const { return m_tileRangeBegin; }
+    int tileRangeEnd() const { return m_tileRangeEnd; }
+
+    // Work items the frame is cut into for pathed_headless --worker
+    int distributedRanges() const { return m_json.value("distributed_ranges", 32); }
+
+    // Fingerprint of the job and scene file that a checkpoint must match.
+    // Run-length settings (spp, time budget) and the seed are left out so a
+    // resumed render can run longer; the seed travels in the checkpoint.
+    uint64_t checkpointHash() const;
+    void restoreSeed(uint64_t seed);
+
     bool showUI() const { return m_json["showUI"].get<bool>(); }
     bool force() const {
         return m_json["force"].is_boolean()
@@ -32,6 +65,58 @@ public:
         return 9999999;
     }
 
+    // Wall-clock limit for the whole render, 0 renders the full spp
+    double timeBudgetSeconds() const { return m_json.value("time_budget_seconds", 0.0); }
+
+    uint64_t seed() const { return m_seed; }
+
+    int tileSize() const { return m_json.value("tile_size", 16); }
+
+    // Light samples per path vertex for next-event estimation in PathTracer
+    int lightSamples() const { return m_json.value("light_samples", 1); }
+
+    // Trace camera rays as rtcIntersect8/16 packets; off traces them one by
+    // one, for comparing primary ray throughput in report.json
+    bool packetPrimaryRays() const { return m_json.value("packet_primary_rays", true); }
+
+    // Paths in flight per wave for WavefrontIntegrator
+    int wavefrontSize() const { return m_json.value("wavefront_size", 1 << 16); }
+
+    // Write first-hit albedo, normal, depth, material ID and sample count
+    // channels into the output EXRs
+    bool aovs() const { return m_json.value("aovs", false); }
+
+    // "exr_compression": "none", "rle", "zips", "zip" or "piz", as a
+    // TINYEXR_COMPRESSIONTYPE_* value
+    int exrCompression() const;
+
+    // Snapshots the background EXR writer holds before the render waits
+    int writerQueueSize() const { return m_json.value("writer_queue_size", 4); }
+
+    // Also save an à-trous denoised "<stem>-denoised" EXR after the final
+    // pass, and optionally with every checkpoint
+    bool denoise() const { return m_json.value("denoise", false); }
+    bool denoiseCheckpoints() const { return m_json.value("denoise_checkpoints", false); }
+    int denoiseIterations() const { return m_json.value("denoise_iterations", 5); }
+
+    // Relative error at which a pixel stops being sampled, 0 disables
+    float adaptiveThreshold() const { return m_json.value("adaptive_threshold", 0.f); }
+    int adaptiveMinSpp() const { return m_json.value("adaptive_min_spp", 16); }
+
+    // "debug_pixels": [[x, y], ...] with y down from the top row; returns
+    // pixel indices whose paths are captured for debugging
+    std::vector<int> debugPixels() const;
+
+    // "crop": [x, y, width, height] in the same coordinates as debug_pixels.
+    // Only the window is sampled and written; the camera keeps its
+    // full-frame projection. The window comes back in pixel rows, counted
+    // up from the bottom. Without a crop this is the whole frame.
+    bool hasCrop() const { return m_json.count("crop") > 0; }
+    Tile cropWindow() const;
+
+    // Optional EXR that fills the image outside the crop window
+    std::string cropComposite() const { return m_json.value("crop_composite", std::string()); }
+
     int portOffset() const { return m_json["port_offset"].get<int>(); }
     int pdfSamples() const { return m_json["pdf_samples"].get<int>(); }
 
@@ -67,9 +152,27 @@ public:
     int lastBounce() const { return m_bounceController.lastBounce(); }
     BounceController bounceController() const { return m_bounceController; }
 
+    // "russian_roulette": { "start_bounce", "weight_window": [min, max],
+    // "max_split" }; disabled when absent
+    RussianRoulette russianRoulette() const;
+
+    // Rewrites report.json with the job and the latest render statistics
+    void writeStats(const nlohmann::json &stats);
+
     std::shared_ptr<Integrator> integrator() const;
+    std::unique_ptr<Sampler> sampler() const;
 
 private:
+    void writeReport() const;
+
     nlohmann::json m_json;
+    nlohmann::json m_stats;
     BounceController m_bounceController;
+    uint64_t m_seed;
+    bool m_resume;
+
+    std::string m_checkpointName;
+    std::string m_outputStem;
+    int m_tileRangeBegin;
+    int m_tileRangeEnd;
 };
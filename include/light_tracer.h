@@ -1,5 +1,6 @@
 #pragma once
 
+#include "accumulator.h"
 #include "bounce_controller.h"
 #include "camera.h"
 #include "integrator.h"
@@ -18,7 +19,7 @@ public:
 
 private:
     void measure(
-        std::vector<float> &radianceLookup,
+        Accumulator &accumulator,
         const Scene &scene,
         RandomGenerator &random
     ) const;
@@ -27,14 +28,15 @@ private:
         const Color &radiance,
         const Intersection &intersection,
         const Scene &scene,
-        std::vector<float> &radianceLookup
+        Accumulator &accumulator
     ) const;
 
     void sampleImage(
-        std::vector<float> &radianceLookup,
-        std::vector<Sample> &sampleLookup,
+        Accumulator &accumulator,
+        SampleLookup &sampleLookup,
         Scene &scene,
-        RandomGenerator &random
+        RandomGenerator &random,
+        int sampleIndex
     ) override;
 
     BounceController m_bounceController;
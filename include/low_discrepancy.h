@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+// Hash-based Owen scrambling following Burley, "Practical Hash-based Owen
+// Scrambling" (JCGT 2020)
+namespace LowDiscrepancy {
+    inline uint32_t reverseBits(uint32_t x)
+    {
+        x = (x << 16) | (x >> 16);
+        x = ((x & 0x00ff00ff) << 8) | ((x & 0xff00ff00) >> 8);
+        x = ((x & 0x0f0f0f0f) << 4) | ((x & 0xf0f0f0f0) >> 4);
+        x = ((x & 0x33333333) << 2) | ((x & 0xcccccccc) >> 2);
+        x = ((x & 0x55555555) << 1) | ((x & 0xaaaaaaaa) >> 1);
+        return x;
+    }
+
+    inline uint32_t hash(uint32_t x)
+    {
+        x ^= x >> 16;
+        x *= 0x7feb352d;
+        x ^= x >> 15;
+        x *= 0x846ca68b;
+        x ^= x >> 16;
+        return x;
+    }
+
+    inline uint32_t hashCombine(uint32_t seed, uint32_t value)
+    {
+        return seed ^ (hash(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+    }
+
+    inline uint32_t laineKarrasPermutation(uint32_t x, uint32_t seed)
+    {
+        x += seed;
+        x ^= x * 0x6c50b47c;
+        x ^= x * 0xb82f1e52;
+        x ^= x * 0xc7afe638;
+        x ^= x * 0x8d22f6e6;
+        return x;
+    }
+
+    // Owen scrambling in base 2: each bit flips based on the bits above it
+    inline uint32_t nestedUniformScramble(uint32_t x, uint32_t seed)
+    {
+        x = reverseBits(x);
+        x = laineKarrasPermutation(x, seed);
+        x = reverseBits(x);
+        return x;
+    }
+
+    // First two Sobol dimensions as 0.32 fixed point
+    inline uint32_t sobol(uint32_t index, int dimension)
+    {
+        if (dimension == 0) { return reverseBits(index); }
+
+        uint32_t result = 0;
+        uint32_t direction = 1u << 31;
+        for (; index; index >>= 1) {
+            if (index & 1) { result ^= direction; }
+            direction ^= direction >> 1;
+        }
+        return result;
+    }
+
+    inline float toFloat(uint32_t x)
+    {
+        return (x >> 8) * 0x1p-24f;
+    }
+
+    // Shuffled, Owen-scrambled 2D Sobol point. Each seed gives an
+    // independent padded dimension pair.
+    inline std::array<float, 2> sobol2D(uint32_t index, uint32_t seed)
+    {
+        const uint32_t shuffledIndex = nestedUniformScramble(index, hashCombine(seed, 0));
+
+        return {
+            toFloat(nestedUniformScramble(sobol(shuffledIndex, 0), hashCombine(seed, 1))),
+            toFloat(nestedUniformScramble(sobol(shuffledIndex, 1), hashCombine(seed, 2)))
+        };
+    }
+
+    inline float sobol1D(uint32_t index, uint32_t seed)
+    {
+        const uint32_t shuffledIndex = nestedUniformScramble(index, hashCombine(seed, 0));
+        return toFloat(nestedUniformScramble(sobol(shuffledIndex, 0), hashCombine(seed, 1)));
+    }
+
+    // Radical inverse with random digit scrambling: every digit level gets
+    // its own hashed offset, including the infinite tail of zero digits
+    inline float scrambledRadicalInverse(int base, uint32_t index, uint32_t seed)
+    {
+        const double invBase = 1.0 / base;
+
+        double result = 0.0;
+        double scale = invBase;
+        for (int level = 0; index > 0 || scale > 1e-8; level++) {
+            const uint32_t digit = index % base;
+            index /= base;
+
+            const uint32_t offset = hashCombine(seed, level) % base;
+            result += ((digit + offset) % base) * scale;
+            scale *= invBase;
+        }
+
+        return std::min((float)result, 0x1.fffffep-1f);
+    }
+};
@@ -1,13 +1,15 @@
 #pragma once
 
 #include "bounce_controller.h"
+#include "russian_roulette.h"
 #include "sample_integrator.h"
+#include "shadow_queue.h"
+
+#include <vector>
 
 class PathTracer : public SampleIntegrator {
 public:
-    PathTracer(BounceController bounceController)
-        : m_bounceController(bounceController)
-    {}
+    PathTracer(BounceController bounceController);
 
     Color L(
         const Intersection &intersection,
@@ -17,21 +19,51 @@ public:
         Sample &sample
     ) const override;
 
+    Color queuedL(
+        const Intersection &intersection,
+        const Scene &scene,
+        RandomGenerator &random,
+        int pixelIndex,
+        Sample &sample,
+        ShadowQueue &shadowQueue
+    ) const override;
+
 private:
+    // A vertex still to be extended: the camera hit, or a split-off copy
+    struct PathVertex {
+        Intersection intersection;
+        Color modulation;
+        int bounce;
+        float invPDF;
+    };
+
+    Color extendPath(
+        const PathVertex &vertex,
+        const Scene &scene,
+        RandomGenerator &random,
+        Sample &sample,
+        ShadowQueue &shadowQueue,
+        std::vector<PathVertex> &pending
+    ) const;
+
     Color direct(
         const Intersection &intersection,
         const BSDFSample &bsdfSample,
+        const Color &modulation,
         const Scene &scene,
         RandomGenerator &random,
-        Sample &sample
+        Sample &sample,
+        ShadowQueue &shadowQueue
     ) const;
 
     Color directSampleLights(
         const Intersection &intersection,
         const BSDFSample &bsdfSample,
+        const Color &modulation,
         const Scene &scene,
         RandomGenerator &random,
-        Sample &sample
+        Sample &sample,
+        ShadowQueue &shadowQueue
     ) const;
 
     Color directSampleBSDF(
@@ -43,4 +75,6 @@ private:
     ) const;
 
     BounceController m_bounceController;
+    int m_lightSamples;
+    RussianRoulette m_russianRoulette;
 };
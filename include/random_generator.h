@@ -1,15 +1,31 @@
 #pragma once
 
-#include <random>
+#include <array>
+#include <cstdint>
 
+// PCG32 (O'Neill 2014). Each generator is a few words of state, so
+// integrators can give every (pixel, sample) pair its own stream and draw
+// successive dimensions from it without sharing state between threads.
+//
+// next() and next2D() are virtual so that a Sampler can stand in wherever a
+// RandomGenerator is taken and hand out low-discrepancy values instead.
 class RandomGenerator {
 public:
     RandomGenerator();
+    RandomGenerator(uint64_t seed, uint64_t stream);
+    virtual ~RandomGenerator() {}
 
-    float next();
+    void reseed(uint64_t seed, uint64_t stream);
+
+    virtual float next();
+    virtual std::array<float, 2> next2D();
+
+    uint32_t nextUInt();
+
+    // Skips ahead as if nextUInt() had been called delta times, in log time
+    void advance(uint64_t delta);
 
 private:
-    std::random_device m_device;
-    std::mt19937 m_generator;
-    std::uniform_real_distribution<float> m_distribution;
+    uint64_t m_state;
+    uint64_t m_increment;
 };
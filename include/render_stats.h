@@ -0,0 +1,58 @@
+#pragma once
+
+#include "json.hpp"
+
+#include <array>
+#include <cstdint>
+
+// Raw event counts from the render threads. Every thread bumps its own copy
+// without synchronization; Integrator::run collects them between passes.
+struct RenderCounters {
+    // The last bucket also counts every longer path
+    static const int PathLengthBuckets = 32;
+
+    uint64_t primaryRays;
+    uint64_t intersectRays;
+    uint64_t shadowRays;
+    uint64_t volumetricIntersectRays;
+    uint64_t volumetricOcclusionRays;
+    uint64_t mediumSteps;
+    uint64_t lightSamples;
+
+    // Thread time spent generating and tracing camera rays
+    uint64_t primaryNanoseconds;
+    std::array<uint64_t, PathLengthBuckets> pathLengths;
+
+    RenderCounters();
+
+    void merge(const RenderCounters &other);
+    void recordPathLength(int segments);
+
+    uint64_t volumetricRays() const {
+        return volumetricIntersectRays + volumetricOcclusionRays;
+    }
+
+    uint64_t totalRays() const {
+        return intersectRays + shadowRays + volumetricRays();
+    }
+
+    // Closest-hit queries, one per path segment
+    uint64_t segmentRays() const {
+        return intersectRays + volumetricIntersectRays;
+    }
+
+    // Camera rays go through testIntersect too; extension rays are the rest
+    uint64_t extensionRays() const {
+        return intersectRays - primaryRays;
+    }
+
+    nlohmann::json toJSON(double renderSeconds) const;
+};
+
+namespace RenderStats {
+    RenderCounters &local();
+
+    // Sums and resets every thread's counters. Only call while no render
+    // threads are running.
+    RenderCounters collect();
+}
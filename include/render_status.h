@@ -11,8 +11,8 @@ public:
     void setSample(int sample) { m_sample = sample; }
     int sample() const { return m_sample; }
 
-    std::shared_ptr<std::vector<Sample> > sampleLookup() const { return m_sampleLookup; }
-    void setSampleLookup(std::shared_ptr<std::vector<Sample> > sampleLookup) {
+    std::shared_ptr<SampleLookup> sampleLookup() const { return m_sampleLookup; }
+    void setSampleLookup(std::shared_ptr<SampleLookup> sampleLookup) {
         m_sampleLookup = sampleLookup;
     }
 
@@ -28,7 +28,7 @@ public:
 
 private:
     int m_sample;
-    std::shared_ptr<std::vector<Sample> > m_sampleLookup;
+    std::shared_ptr<SampleLookup> m_sampleLookup;
     std::shared_ptr<std::vector<DataSource::Point> > m_photons;
     std::shared_ptr<DataSource> m_dataSource;
 };
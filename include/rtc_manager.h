@@ -10,6 +10,15 @@
 #include <utility>
 #include <vector>
 
+// Geometry masks. Geometry keeps Embree's all-bits default unless every
+// surface on it is a media boundary, in which case it carries only
+// Boundary and rays that ignore passthroughs skip it during traversal.
+namespace RTCMask {
+    const unsigned int All = 0xffffffff;
+    const unsigned int Boundary = 1u << 1;
+    const unsigned int Surfaces = All & ~Boundary;
+};
+
 class RTCManager {
 public:
     RTCManager(RTCScene rootScene);
@@ -26,13 +35,15 @@ public:
         std::vector<std::shared_ptr<Surface> > &geometrySurfaces
     );
 
-    std::shared_ptr<Surface> lookupInstancedSurface(
+    // Surfaces are owned here for the scene's lifetime, so hits hand out
+    // plain pointers and never touch reference counts
+    const Surface *lookupInstancedSurface(
         int rtcGeometryID,
         int rtcPrimitiveID,
         unsigned int *rtcInstanceIDs
     ) const;
 
-    std::shared_ptr<Surface> lookupSurface(
+    const Surface *lookupSurface(
         int rtcGeometryID,
         int rtcPrimitiveID
     ) const;
@@ -47,19 +58,35 @@ public:
         return m_rtcSceneToSurfaces.at(m_rootScene);
     }
 
+    // Installs the callback and boundary mask on geometry with media
+    // boundaries (containers with an internal medium) only; everything else
+    // traverses without a filter
     void registerFilters(void (&callback)(const RTCFilterFunctionNArguments *));
 
+    // Flattens everything registered so far into the tables the lookups
+    // use. Call once after the last registration, before tracing.
+    void bakeLookupTables();
+
     void printStats();
 
 private:
+    // One per (scene, geometry ID), with each scene's geometries contiguous
+    // from its base index. Instances point at their child scene's base.
+    struct GeometryEntry {
+        int surfaceOffset;
+        int instanceBase;
+        RTCGeometry rtcGeometry;
+    };
+
+    int resolveInstanceBase(const unsigned int *rtcInstanceIDs) const;
+
     RTCScene m_rootScene;
 
-    std::shared_ptr<Surface> lookupSurface(
-        RTCScene rtcScene,
-        int rtcGeometryID,
-        int rtcPrimitiveID
-    ) const;
+    // Baked tables; the root scene's geometries start at 0
+    std::vector<GeometryEntry> m_geometries;
+    std::vector<const Surface *> m_surfaces;
 
+    // Registration state
     std::map<std::pair<RTCScene, int>, RTCScene> m_rtcSceneLookup;
     std::map<RTCScene, NestedSurfaceVector> m_rtcSceneToSurfaces;
     std::vector<std::pair<RTCScene, int> > m_rtcRegistrationQueue;
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "color.h"
+#include "random_generator.h"
+
+// Weight-window Russian roulette and splitting, after Vorba and Krivanek,
+// "Adjoint-Driven Russian Roulette and Splitting in Light Transport
+// Simulation" (2016). The window is on path throughput luminance: paths
+// below it are killed or boosted back up to the window, paths above it are
+// split into several lighter copies.
+class RussianRoulette {
+public:
+    // Never terminates or splits
+    RussianRoulette();
+    RussianRoulette(int startBounce, float minWeight, float maxWeight, int maxSplit);
+
+    bool enabled() const { return m_startBounce >= 0; }
+
+    // Returns how many copies the path continues as, 0 to terminate. Every
+    // copy's throughput must be scaled by *weight to stay unbiased.
+    int evaluate(
+        int bounce,
+        const Color &throughput,
+        RandomGenerator &random,
+        float *weight
+    ) const;
+
+    int startBounce() const { return m_startBounce; }
+    float minWeight() const { return m_minWeight; }
+    float maxWeight() const { return m_maxWeight; }
+    int maxSplit() const { return m_maxSplit; }
+
+private:
+    int m_startBounce;
+    float m_minWeight;
+    float m_maxWeight;
+    int m_maxSplit;
+};
@@ -3,6 +3,7 @@
 #include "color.h"
 #include "point.h"
 
+#include <map>
 #include <vector>
 
 struct Contribution {
@@ -16,12 +17,36 @@ struct ShadowTest {
     bool occluded;
 };
 
+// Debug record of one pixel sample's path. Only pixels picked for capture
+// record anything; everywhere else the record calls are a skipped branch
+// and the vectors never allocate.
 struct Sample {
+    bool recording;
+
     std::vector<Point3> eyePoints;
     std::vector<ShadowTest> shadowTests;
     std::vector<Contribution> contributions;
 
     Sample()
-    : eyePoints(), shadowTests(), contributions()
+    : recording(false), eyePoints(), shadowTests(), contributions()
+    {}
+
+    Sample(bool recording)
+    : recording(recording), eyePoints(), shadowTests(), contributions()
     {}
+
+    void recordEyePoint(const Point3 &eyePoint) {
+        if (recording) { eyePoints.push_back(eyePoint); }
+    }
+
+    void recordShadowTest(const ShadowTest &shadowTest) {
+        if (recording) { shadowTests.push_back(shadowTest); }
+    }
+
+    void recordContribution(const Contribution &contribution) {
+        if (recording) { contributions.push_back(contribution); }
+    }
 };
+
+// Captured samples for one pass, keyed by pixel index
+using SampleLookup = std::map<int, Sample>;
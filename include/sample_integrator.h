@@ -1,9 +1,15 @@
 #pragma once
 
+#include "accumulator.h"
 #include "integrator.h"
+#include "intersection.h"
 #include "random_generator.h"
+#include "ray.h"
 #include "sample.h"
+#include "sampler.h"
 #include "scene.h"
+#include "shadow_queue.h"
+#include "tile_scheduler.h"
 
 #include <vector>
 
@@ -17,21 +23,57 @@ public:
         Sample &sample
     ) const = 0;
 
+    // Like L, but next-event shadow rays may be left in shadowQueue instead
+    // of traced. Integrators that don't defer them keep this default.
+    virtual Color queuedL(
+        const Intersection &intersection,
+        const Scene &scene,
+        RandomGenerator &random,
+        int pixelIndex,
+        Sample &sample,
+        ShadowQueue &shadowQueue
+    ) const {
+        return L(intersection, scene, random, pixelIndex, sample);
+    }
+
 protected:
+    bool adaptiveSampling() const override { return true; }
+
     void sampleImage(
-        std::vector<float> &radianceLookup,
-        std::vector<Sample> &sampleLookup,
+        Accumulator &accumulator,
+        SampleLookup &sampleLookup,
         Scene &scene,
-        RandomGenerator &random
+        RandomGenerator &random,
+        int sampleIndex
     ) override;
 
-    void samplePixel(
+    // Camera rays for a tile's active pixels, traced together as packets.
+    // dimensions holds where each pixel's sampler stream left off.
+    struct CameraRays {
+        std::vector<int> pixelIndices;
+        std::vector<int> dimensions;
+        std::vector<Ray> rays;
+        std::vector<Intersection> intersections;
+    };
+
+    void traceCameraRays(
+        const Tile &tile,
+        int width,
+        const Accumulator &accumulator,
+        const Scene &scene,
+        Sampler &sampler,
+        CameraRays &cameraRays
+    );
+
+    Color shadePixel(
         int row, int col,
         int width, int height,
-        std::vector<float> &radianceLookup,
-        std::vector<Sample> &sampleLookup,
+        const Ray &ray,
+        const Intersection &intersection,
+        SampleLookup &sampleLookup,
         const Scene &scene,
-        RandomGenerator &random
+        RandomGenerator &random,
+        ShadowQueue &shadowQueue
     );
 
 };
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "random_generator.h"
+
+#include <cstdint>
+
+// Hands out the random numbers for one pixel sample at a time. Integrators
+// keep taking a RandomGenerator &; each draw consumes the next dimension of
+// the current (pixel, sample) pair.
+//
+// The base sampler draws independent values from the pixel's PCG stream.
+class Sampler : public RandomGenerator {
+public:
+    Sampler(uint64_t seed);
+
+    virtual void startPixelSample(int pixelIndex, int sampleIndex);
+
+    // Picks a pixel sample back up where dimension() left it, so integrators
+    // that interleave many paths only need to keep three ints per path
+    void resumePixelSample(int pixelIndex, int sampleIndex, int dimension);
+
+    float next() override;
+
+    int dimension() const { return m_dimension; }
+
+protected:
+    // How many values the independent stream has handed out by the time
+    // dimension is reached
+    virtual uint64_t streamPosition(int dimension) const { return dimension; }
+
+    uint64_t m_seed;
+    int m_pixelIndex;
+    int m_sampleIndex;
+    int m_dimension;
+};
@@ -10,37 +10,34 @@
 #include "rtc_manager.h"
 #include "surface.h"
 #include "types.h"
+#include "volume_event.h"
 #include "world_frame.h"
 #include "vector.h"
 
 #include <embree3/rtcore.h>
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
 class Camera;
 class Ray;
 
-struct VolumeEvent {
-    float t;
-    std::shared_ptr<Medium> mediumPtr;
-};
-
 struct IntersectionResult {
     Intersection intersection;
-    std::vector<VolumeEvent> volumeEvents;
+    VolumeEventList volumeEvents;
 };
 
 struct OcclusionResult {
     bool isOccluded;
-    std::vector<VolumeEvent> volumeEvents;
+    VolumeEventList volumeEvents;
 };
 
 struct CustomRTCIntersectContext {
     RTCIntersectContext context;
     bool shouldIntersectPassthroughs;
     const RTCManager *rtcManagerPtr;
-    std::vector<VolumeEvent> volumeEvents;
+    VolumeEventList volumeEvents;
 };
 
 struct LightSample {
@@ -96,6 +93,20 @@ public:
     bool testOcclusion(const Ray &ray, float maxT) const;
     OcclusionResult testVolumetricOcclusion(const Ray &ray, float maxT) const;
 
+    // Ray streams for wavefront integrators, traced with rtc*1M
+    void testIntersect(const Ray *rays, int count, Intersection *intersections) const;
+    void testOcclusion(
+        const Ray *rays,
+        const float *maxTs,
+        int count,
+        uint8_t *occluded
+    ) const;
+
+    // Coherent rays (camera rays from one tile) traced as rtcIntersect8/16
+    // packets, whichever the device supports natively
+    void testIntersectPacket(const Ray *rays, int count, Intersection *intersections) const;
+    int packetWidth() const { return m_packetWidth; }
+
     const NestedSurfaceVector &getSurfaces() const { return m_rtcManagerPtr->getSurfaces(); }
     std::shared_ptr<Camera> getCamera() const { return m_camera; }
 
@@ -121,10 +132,18 @@ private:
     ) const;
     void registerOcclusionFilters() const;
 
+    Intersection buildIntersection(
+        const Ray &ray,
+        const RTCRayHit &rayHit,
+        bool orientDoubleSided
+    ) const;
+
     std::unique_ptr<RTCManager> m_rtcManagerPtr;
 
     std::vector<std::shared_ptr<Light> > m_lights;
     std::shared_ptr<EnvironmentLight> m_environmentLight;
 
     std::shared_ptr<Camera> m_camera;
+
+    int m_packetWidth;
 };
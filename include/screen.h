@@ -70,7 +70,7 @@ private:
     nanogui::ref<nanogui::Widget> m_buttonsGroup;
     nanogui::ref<nanogui::Label> m_sampleLabel;
 
-    std::vector<std::shared_ptr<std::vector<Sample> > > m_sampleLookups;
+    std::vector<std::shared_ptr<SampleLookup> > m_sampleLookups;
     std::vector<std::shared_ptr<std::vector<DataSource::Point> > > m_photonLists;
     std::vector<std::shared_ptr<DataSource> > m_dataSources;
 };
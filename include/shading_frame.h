@@ -0,0 +1,32 @@
+#pragma once
+
+#include "transform.h"
+#include "vector.h"
+
+// Orthonormal shading frame with the normal as local +y. Rotations only, so
+// going back to local space is the transpose: three dot products.
+class ShadingFrame {
+public:
+    // All-zero placeholder, for records that build their frame later
+    ShadingFrame();
+
+    // Same axes as normalToWorldSpace(normal, woWorld)
+    ShadingFrame(const Vector3 &normal, const Vector3 &woWorld);
+
+    Vector3 toWorld(const Vector3 &local) const {
+        return m_xAxis * local.x() + m_normal * local.y() + m_zAxis * local.z();
+    }
+
+    Vector3 toLocal(const Vector3 &world) const {
+        return Vector3(m_xAxis.dot(world), m_normal.dot(world), m_zAxis.dot(world));
+    }
+
+    // For APIs that still take a full Transform
+    Transform toWorldTransform() const;
+    Transform toLocalTransform() const;
+
+private:
+    Vector3 m_xAxis;
+    Vector3 m_normal;
+    Vector3 m_zAxis;
+};
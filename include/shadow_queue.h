@@ -0,0 +1,37 @@
+#pragma once
+
+#include "color.h"
+#include "ray.h"
+
+#include <cstdint>
+#include <vector>
+
+class Scene;
+
+// Deferred next-event estimation. Shading pushes a shadow ray together with
+// the contribution it carries if unoccluded; resolve() traces the whole
+// queue as rtcOccluded1M streams and credits the clear ones to their owner.
+class ShadowQueue {
+public:
+    ShadowQueue();
+
+    // Queries pushed from now on belong to this owner (e.g. a tile slot)
+    void setOwner(int owner) { m_owner = owner; }
+
+    void push(const Ray &ray, float maxT, const Color &contribution);
+
+    int size() const { return m_rays.size(); }
+    bool empty() const { return m_rays.empty(); }
+
+    // Adds unoccluded contributions into results[owner] and empties the queue
+    void resolve(const Scene &scene, std::vector<Color> &results);
+
+private:
+    int m_owner;
+
+    std::vector<int> m_owners;
+    std::vector<Ray> m_rays;
+    std::vector<float> m_maxTs;
+    std::vector<Color> m_contributions;
+    std::vector<uint8_t> m_occluded;
+};
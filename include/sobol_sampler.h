@@ -0,0 +1,22 @@
+#pragma once
+
+#include "sampler.h"
+
+#include <array>
+#include <cstdint>
+
+// Owen-scrambled Sobol points, padded two dimensions at a time. Every pixel
+// gets its own scramble, and every dimension (pair) its own index shuffle so
+// that dimensions stay uncorrelated.
+class SobolSampler : public Sampler {
+public:
+    SobolSampler(uint64_t seed);
+
+    void startPixelSample(int pixelIndex, int sampleIndex) override;
+
+    float next() override;
+    std::array<float, 2> next2D() override;
+
+private:
+    uint32_t m_pixelSeed;
+};
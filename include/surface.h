@@ -35,9 +35,11 @@ public:
     float pdf(const Point3 &point, Measure measure) const;
     float pdf(const Point3 &point, const Point3 &referencePoint, Measure measure) const;
 
-    std::shared_ptr<Shape> getShape() const;
-    std::shared_ptr<Material> getMaterial() const;
-    std::shared_ptr<Medium> getInternalMedium() const { return m_internalMedium; }
+    // References into the surface, which lives as long as the scene; copy
+    // them only to share ownership
+    const std::shared_ptr<Shape> &getShape() const { return m_shape; }
+    const std::shared_ptr<Material> &getMaterial() const { return m_material; }
+    const std::shared_ptr<Medium> &getInternalMedium() const { return m_internalMedium; }
     int getFaceIndex() const { return m_faceIndex; }
 
     Color getRadiance() const;
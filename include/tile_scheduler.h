@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+struct Tile {
+    int startRow;
+    int endRow;
+    int startCol;
+    int endCol;
+};
+
+struct TileStats {
+    int tileCount;
+    int stealCount;
+    double meanTileSeconds;
+    double maxTileSeconds;
+    double meanWorkerSeconds;
+    double maxWorkerSeconds;
+
+    // 1.0 is perfectly balanced; the slowest worker sets the pass time
+    double imbalance() const {
+        if (meanWorkerSeconds <= 0.0) { return 1.0; }
+        return maxWorkerSeconds / meanWorkerSeconds;
+    }
+};
+
+// Splits the frame into Morton-ordered tiles. Each worker starts on its own
+// contiguous range of the curve and steals from the back of the busiest
+// worker's range once it runs dry.
+class TileScheduler {
+public:
+    TileScheduler(int width, int height, int tileSize);
+
+    // Tiles only the given region of the frame, e.g. a crop window
+    TileScheduler(const Tile &region, int tileSize);
+
+    int tileCount() const { return m_tiles.size(); }
+    const Tile &tile(int tileIndex) const { return m_tiles[tileIndex]; }
+
+    void reset(int workerCount);
+    bool next(int workerID, int *tileIndex);
+
+    void recordTime(int workerID, int tileIndex, double seconds);
+    TileStats stats() const;
+
+private:
+    struct alignas(64) WorkerState {
+        std::atomic<uint64_t> range;
+        int stealCount;
+        double busySeconds;
+    };
+
+    bool steal(int workerID, int *tileIndex);
+
+    std::vector<Tile> m_tiles;
+    std::vector<double> m_tileSeconds;
+    std::vector<WorkerState> m_workers;
+};
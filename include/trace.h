@@ -0,0 +1,27 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+// Coarse timeline of startup and render phases, written as Chrome
+// trace-event JSON (chrome://tracing, Perfetto). Meant for events that
+// happen at most a few thousand times per run, not per ray.
+namespace Trace {
+    class Scope {
+    public:
+        Scope(const std::string &name);
+        Scope(const std::string &name, const std::string &detail);
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        std::string m_name;
+        std::string m_detail;
+        std::chrono::steady_clock::time_point m_begin;
+    };
+
+    // Writes every event recorded so far; safe to call repeatedly
+    void write(const std::string &path);
+}
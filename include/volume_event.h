@@ -0,0 +1,57 @@
+#pragma once
+
+#include <assert.h>
+#include <cstddef>
+
+class Medium;
+
+struct VolumeEvent {
+    float t;
+    const Medium *medium;
+};
+
+// Passthrough crossings along one ray, kept sorted by t. Storage is inline
+// so the Embree filter callback never allocates; a ray that crosses more
+// boundaries than fit keeps the nearest ones.
+class VolumeEventList {
+public:
+    static const int Capacity = 8;
+
+    VolumeEventList() : m_size(0) {}
+
+    // Insertion sort step. Duplicate t values are dropped, Embree reports
+    // them when a ray grazes an edge shared by two triangles
+    void insert(const VolumeEvent &event) {
+        for (int i = 0; i < m_size; i++) {
+            if (m_events[i].t == event.t) { return; }
+        }
+
+        int slot = m_size;
+        if (m_size == Capacity) {
+            if (event.t >= m_events[Capacity - 1].t) { return; }
+            slot = Capacity - 1;
+        } else {
+            m_size += 1;
+        }
+
+        for (; slot > 0 && m_events[slot - 1].t > event.t; slot--) {
+            m_events[slot] = m_events[slot - 1];
+        }
+        m_events[slot] = event;
+    }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    const VolumeEvent &operator[](size_t index) const {
+        assert(index < (size_t)m_size);
+        return m_events[index];
+    }
+
+    const VolumeEvent *begin() const { return m_events; }
+    const VolumeEvent *end() const { return m_events + m_size; }
+
+private:
+    VolumeEvent m_events[Capacity];
+    int m_size;
+};
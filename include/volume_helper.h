@@ -1,9 +1,9 @@
 #pragma once
 
 #include "color.h"
+#include "volume_event.h"
 
 #include <memory>
-#include <vector>
 
 class Medium;
 class Point3;
@@ -11,8 +11,6 @@ class RandomGenerator;
 class Ray;
 class Scene;
 
-struct VolumeEvent;
-
 namespace VolumeHelper {
     Color directSampleLights(
         const Medium &medium,
@@ -23,7 +21,7 @@ namespace VolumeHelper {
 
     Color rayTransmission(
         const Ray &ray,
-        const std::vector<VolumeEvent> &volumeEvents,
+        const VolumeEventList &volumeEvents,
         const std::shared_ptr<Medium> &mediumPtr
     );
 
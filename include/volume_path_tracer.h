@@ -8,16 +8,16 @@
 #include "point.h"
 #include "ray.h"
 #include "random_generator.h"
+#include "russian_roulette.h"
 #include "sample_integrator.h"
 #include "scene.h"
 
 #include <memory>
+#include <vector>
 
 class VolumePathTracer : public SampleIntegrator {
 public:
-    VolumePathTracer(BounceController bounceController)
-        : m_bounceController(bounceController)
-    {}
+    VolumePathTracer(BounceController bounceController);
 
     Color L(
         const Intersection &intersection,
@@ -28,6 +28,23 @@ public:
     ) const override;
 
 private:
+    // A vertex still to be extended: the camera hit, or a split-off copy
+    struct PathVertex {
+        Intersection intersection;
+        std::shared_ptr<Medium> mediumPtr;
+        Color modulation;
+        int bounce;
+        float invPDF;
+    };
+
+    Color extendPath(
+        const PathVertex &vertex,
+        const Scene &scene,
+        RandomGenerator &random,
+        Sample &sample,
+        std::vector<PathVertex> &pending
+    ) const;
+
     Color transmittance(
         const std::shared_ptr<Medium> &mediumPtr,
         const Intersection &sourceIntersection,
@@ -43,4 +60,5 @@ private:
     ) const;
 
     BounceController m_bounceController;
+    RussianRoulette m_russianRoulette;
 };
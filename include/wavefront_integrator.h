@@ -0,0 +1,98 @@
+#pragma once
+
+#include "accumulator.h"
+#include "bounce_controller.h"
+#include "color.h"
+#include "integrator.h"
+#include "intersection.h"
+#include "material.h"
+#include "random_generator.h"
+#include "ray.h"
+#include "sample.h"
+#include "sampler.h"
+#include "scene.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Same estimator as PathTracer, but paths advance together one bounce at a
+// time: every stage works over a whole wave of path states, rays are traced
+// as streams, and shading runs sorted by material. The BSDF-sampled MIS ray
+// doubles as the extension ray, so each vertex costs one closest-hit query.
+class WavefrontIntegrator : public Integrator {
+public:
+    WavefrontIntegrator(BounceController bounceController)
+        : m_bounceController(bounceController)
+    {}
+
+protected:
+    bool adaptiveSampling() const override { return true; }
+
+    void sampleImage(
+        Accumulator &accumulator,
+        SampleLookup &sampleLookup,
+        Scene &scene,
+        RandomGenerator &random,
+        int sampleIndex
+    ) override;
+
+private:
+    // Path state in structure-of-arrays form, indexed by path slot. Samplers
+    // are resumed from (pixelIndex, sampleIndex, dimension) at each stage
+    struct PathStates {
+        std::vector<int> pixelIndex;
+        std::vector<int> sampleIndex;
+        std::vector<int> dimension;
+        std::vector<int> bounce;
+        std::vector<int> segments;
+        std::vector<Color> radiance;
+        std::vector<Color> modulation;
+        std::vector<Intersection> intersection;
+        std::vector<BSDFSample> bsdfSample;
+
+        void resize(int count);
+    };
+
+    struct ShadowQueue {
+        std::vector<int> path;
+        std::vector<Ray> rays;
+        std::vector<float> maxTs;
+        std::vector<Color> contributions;
+        std::vector<uint8_t> occluded;
+
+        void clear();
+    };
+
+    void traceWave(
+        const std::vector<int> &pixelIndices,
+        Accumulator &accumulator,
+        const Scene &scene
+    );
+
+    void generateCameraRays(int width, const Scene &scene);
+    void shadePrimary(const Scene &scene);
+    void generateShadowRays(const Scene &scene);
+    void generateExtensionRays();
+    void shadeExtensions(const Scene &scene);
+
+    // Camera rays are coherent enough to trace as packets
+    void traceIntersections(const Scene &scene, bool coherent);
+    void traceShadows(const Scene &scene);
+
+    int m_waveSize;
+
+    // One per OpenMP thread
+    std::vector<std::unique_ptr<Sampler> > m_samplers;
+
+    PathStates m_paths;
+    ShadowQueue m_shadows;
+
+    // Paths still alive, and the rays and hits for their next segment
+    std::vector<int> m_active;
+    std::vector<Ray> m_rays;
+    std::vector<Intersection> m_hits;
+    std::vector<uint8_t> m_sampledMIS;
+
+    BounceController m_bounceController;
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// File-based work queue shared by any number of processes on one machine or
+// one shared filesystem. Each item is a file under pending/; a worker claims
+// it by renaming it into claimed/ and finishes it by renaming it into done/.
+// rename() is atomic, so no two workers can take the same item.
+class WorkQueue {
+public:
+    WorkQueue(const std::string &directory);
+
+    // Lays out items [0, itemCount). Every worker may call this; the queue
+    // is built off to the side and renamed into place, so only the first
+    // caller's queue survives and nobody sees a half-built one. A queue left
+    // behind by a job with a different key is replaced rather than joined.
+    // workerName must be unique across every host sharing the queue.
+    bool create(int itemCount, uint64_t jobKey, const std::string &workerName);
+
+    // False once the queue is drained, or if it stays missing
+    bool claim(const std::string &workerName, int *item);
+    bool complete(int item);
+
+    int pendingCount() const;
+    int doneCount() const;
+
+private:
+    bool hasKey(const std::string &directory, uint64_t jobKey) const;
+    std::string itemPath(const std::string &state, int item) const;
+
+    std::string m_directory;
+};
@@ -0,0 +1,253 @@
+#include "accumulator.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+// Keeps near-black pixels from needing an unbounded number of samples
+static const float ErrorLuminanceFloor = 1e-3f;
+
+Accumulator::Accumulator(int width, int height)
+    : m_width(width),
+      m_height(height),
+      m_radiance(3 * width * height, 0.f),
+      m_luminanceMean(width * height, 0.f),
+      m_luminanceM2(width * height, 0.f),
+      m_sampleCounts(width * height, 0),
+      m_active(width * height, 1),
+      m_activeCount(width * height)
+{}
+
+void Accumulator::add(int pixelIndex, const Color &color)
+{
+    m_radiance[3 * pixelIndex + 0] += color.r();
+    m_radiance[3 * pixelIndex + 1] += color.g();
+    m_radiance[3 * pixelIndex + 2] += color.b();
+
+    const int count = ++m_sampleCounts[pixelIndex];
+
+    const float luminance = color.luminance();
+    const float delta = luminance - m_luminanceMean[pixelIndex];
+    m_luminanceMean[pixelIndex] += delta / count;
+    m_luminanceM2[pixelIndex] += delta * (luminance - m_luminanceMean[pixelIndex]);
+}
+
+void Accumulator::splat(int pixelIndex, const Color &color)
+{
+    m_radiance[3 * pixelIndex + 0] += color.r();
+    m_radiance[3 * pixelIndex + 1] += color.g();
+    m_radiance[3 * pixelIndex + 2] += color.b();
+}
+
+void Accumulator::addSplatPass()
+{
+    for (int &count : m_sampleCounts) {
+        count += 1;
+    }
+}
+
+uint64_t Accumulator::totalSamples() const
+{
+    uint64_t total = 0;
+    for (int count : m_sampleCounts) {
+        total += count;
+    }
+    return total;
+}
+
+Color Accumulator::mean(int pixelIndex) const
+{
+    const int count = m_sampleCounts[pixelIndex];
+    if (count == 0) { return Color(0.f); }
+
+    return Color(
+        m_radiance[3 * pixelIndex + 0] / count,
+        m_radiance[3 * pixelIndex + 1] / count,
+        m_radiance[3 * pixelIndex + 2] / count
+    );
+}
+
+float Accumulator::relativeError(int pixelIndex) const
+{
+    const int count = m_sampleCounts[pixelIndex];
+    if (count < 2) { return INFINITY; }
+
+    const float variance = m_luminanceM2[pixelIndex] / (count - 1);
+    const float standardError = std::sqrt(variance / count);
+
+    return standardError / (std::abs(m_luminanceMean[pixelIndex]) + ErrorLuminanceFloor);
+}
+
+float Accumulator::meanVariance(int pixelIndex) const
+{
+    const int count = m_sampleCounts[pixelIndex];
+    if (count < 2) {
+        return m_luminanceMean[pixelIndex] * m_luminanceMean[pixelIndex];
+    }
+
+    return m_luminanceM2[pixelIndex] / (count - 1) / count;
+}
+
+void Accumulator::merge(const Accumulator &other)
+{
+    for (int i = 0; i < pixelCount(); i++) {
+        const int otherCount = other.m_sampleCounts[i];
+        if (otherCount == 0) { continue; }
+
+        const int count = m_sampleCounts[i];
+        const int totalCount = count + otherCount;
+
+        const float delta = other.m_luminanceMean[i] - m_luminanceMean[i];
+        m_luminanceMean[i] += delta * otherCount / totalCount;
+        m_luminanceM2[i] += other.m_luminanceM2[i]
+            + delta * delta * ((float)count * otherCount / totalCount);
+
+        m_sampleCounts[i] = totalCount;
+        for (int channel = 0; channel < 3; channel++) {
+            m_radiance[3 * i + channel] += other.m_radiance[3 * i + channel];
+        }
+    }
+}
+
+void Accumulator::deactivate(int pixelIndex)
+{
+    if (!m_active[pixelIndex]) { return; }
+
+    m_active[pixelIndex] = 0;
+    m_activeCount -= 1;
+}
+
+int Accumulator::updateConvergence(float threshold, int minSamples)
+{
+    m_activeCount = 0;
+    for (int i = 0; i < pixelCount(); i++) {
+        if (!m_active[i]) { continue; }
+
+        if (m_sampleCounts[i] >= minSamples && relativeError(i) < threshold) {
+            m_active[i] = 0;
+        } else {
+            m_activeCount += 1;
+        }
+    }
+
+    return m_activeCount;
+}
+
+static const char CheckpointMagic[8] = { 'P', 'A', 'T', 'H', 'A', 'C', 'C', '1' };
+static const uint32_t CheckpointVersion = 1;
+
+template <typename T>
+static void writeValue(std::ofstream &stream, const T &value)
+{
+    stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T>
+static void writeArray(std::ofstream &stream, const std::vector<T> &values)
+{
+    stream.write(
+        reinterpret_cast<const char *>(values.data()),
+        values.size() * sizeof(T)
+    );
+}
+
+template <typename T>
+static bool readValue(std::ifstream &stream, T *value)
+{
+    stream.read(reinterpret_cast<char *>(value), sizeof(T));
+    return (bool)stream;
+}
+
+template <typename T>
+static bool readArray(std::ifstream &stream, std::vector<T> &values)
+{
+    stream.read(
+        reinterpret_cast<char *>(values.data()),
+        values.size() * sizeof(T)
+    );
+    return (bool)stream;
+}
+
+bool Accumulator::saveCheckpoint(const std::string &path, const CheckpointInfo &info) const
+{
+    const std::string temporaryPath = path + ".tmp";
+
+    {
+        std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!stream) { return false; }
+
+        stream.write(CheckpointMagic, sizeof(CheckpointMagic));
+        writeValue(stream, CheckpointVersion);
+        writeValue(stream, info.jobHash);
+        writeValue(stream, info.seed);
+        writeValue<int32_t>(stream, info.passes);
+        writeValue<int32_t>(stream, m_width);
+        writeValue<int32_t>(stream, m_height);
+
+        writeArray(stream, m_radiance);
+        writeArray(stream, m_luminanceMean);
+        writeArray(stream, m_luminanceM2);
+        writeArray(stream, m_sampleCounts);
+        writeArray(stream, m_active);
+
+        stream.flush();
+        if (!stream) { return false; }
+    }
+
+    return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+}
+
+bool Accumulator::loadCheckpoint(
+    const std::string &path,
+    uint64_t expectedJobHash,
+    CheckpointInfo *info
+) {
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) { return false; }
+
+    char magic[sizeof(CheckpointMagic)];
+    stream.read(magic, sizeof(magic));
+    if (!stream || std::memcmp(magic, CheckpointMagic, sizeof(magic)) != 0) { return false; }
+
+    uint32_t version;
+    uint64_t jobHash, seed;
+    int32_t passes, width, height;
+    if (!readValue(stream, &version) || version != CheckpointVersion) { return false; }
+    if (!readValue(stream, &jobHash) || jobHash != expectedJobHash) { return false; }
+    if (!readValue(stream, &seed) || !readValue(stream, &passes)) { return false; }
+    if (!readValue(stream, &width) || !readValue(stream, &height)) { return false; }
+    if (width != m_width || height != m_height) { return false; }
+
+    std::vector<float> radiance(m_radiance.size());
+    std::vector<float> luminanceMean(m_luminanceMean.size());
+    std::vector<float> luminanceM2(m_luminanceM2.size());
+    std::vector<int> sampleCounts(m_sampleCounts.size());
+    std::vector<uint8_t> active(m_active.size());
+
+    if (!readArray(stream, radiance)
+        || !readArray(stream, luminanceMean)
+        || !readArray(stream, luminanceM2)
+        || !readArray(stream, sampleCounts)
+        || !readArray(stream, active)
+    ) {
+        return false;
+    }
+
+    m_radiance.swap(radiance);
+    m_luminanceMean.swap(luminanceMean);
+    m_luminanceM2.swap(luminanceM2);
+    m_sampleCounts.swap(sampleCounts);
+    m_active.swap(active);
+
+    m_activeCount = 0;
+    for (uint8_t isActive : m_active) {
+        m_activeCount += isActive;
+    }
+
+    info->jobHash = jobHash;
+    info->seed = seed;
+    info->passes = passes;
+
+    return true;
+}
@@ -0,0 +1,117 @@
+#include "aov_buffer.h"
+
+AOVBuffer::AOVBuffer(int width, int height)
+    : m_width(width),
+      m_height(height),
+      m_albedo(3 * width * height, 0.f),
+      m_normal(3 * width * height, 0.f),
+      m_depth(width * height, 0.f),
+      m_materialIDs(width * height, -1),
+      m_rayCounts(width * height, 0),
+      m_hitCounts(width * height, 0)
+{}
+
+void AOVBuffer::assignMaterialIDs(const NestedSurfaceVector &surfaces)
+{
+    m_materialTable.clear();
+    for (const auto &geometrySurfaces : surfaces) {
+        for (const auto &surface : geometrySurfaces) {
+            const Material *material = surface->getMaterial().get();
+            if (m_materialTable.count(material) == 0) {
+                const int materialID = m_materialTable.size();
+                m_materialTable[material] = materialID;
+            }
+        }
+    }
+}
+
+void AOVBuffer::add(int pixelIndex, const Intersection &intersection)
+{
+    m_rayCounts[pixelIndex] += 1;
+    if (!intersection.hit) { return; }
+
+    const Color albedo = intersection.material->albedo(intersection);
+    m_albedo[3 * pixelIndex + 0] += albedo.r();
+    m_albedo[3 * pixelIndex + 1] += albedo.g();
+    m_albedo[3 * pixelIndex + 2] += albedo.b();
+
+    const Vector3 &normal = intersection.shadingNormal;
+    m_normal[3 * pixelIndex + 0] += normal.x();
+    m_normal[3 * pixelIndex + 1] += normal.y();
+    m_normal[3 * pixelIndex + 2] += normal.z();
+
+    m_depth[pixelIndex] += intersection.t;
+
+    if (m_hitCounts[pixelIndex]++ == 0) {
+        auto entry = m_materialTable.find(intersection.material);
+        if (entry != m_materialTable.end()) {
+            m_materialIDs[pixelIndex] = entry->second;
+        }
+    }
+}
+
+Color AOVBuffer::albedo(int pixelIndex) const
+{
+    const int count = m_rayCounts[pixelIndex];
+    if (count == 0) { return Color(0.f); }
+
+    return Color(
+        m_albedo[3 * pixelIndex + 0] / count,
+        m_albedo[3 * pixelIndex + 1] / count,
+        m_albedo[3 * pixelIndex + 2] / count
+    );
+}
+
+Vector3 AOVBuffer::normal(int pixelIndex) const
+{
+    const int count = m_rayCounts[pixelIndex];
+    if (count == 0) { return Vector3(0.f); }
+
+    return Vector3(
+        m_normal[3 * pixelIndex + 0] / count,
+        m_normal[3 * pixelIndex + 1] / count,
+        m_normal[3 * pixelIndex + 2] / count
+    );
+}
+
+float AOVBuffer::depth(int pixelIndex) const
+{
+    const int count = m_hitCounts[pixelIndex];
+    if (count == 0) { return 0.f; }
+
+    return m_depth[pixelIndex] / count;
+}
+
+void AOVBuffer::write(Image &image) const
+{
+    const int pixelCount = m_width * m_height;
+
+    std::vector<float> channels[8];
+    for (auto &channel : channels) {
+        channel.resize(pixelCount);
+    }
+
+    for (int i = 0; i < pixelCount; i++) {
+        const Color albedo = this->albedo(i);
+        channels[0][i] = albedo.r();
+        channels[1][i] = albedo.g();
+        channels[2][i] = albedo.b();
+
+        const Vector3 normal = this->normal(i);
+        channels[3][i] = normal.x();
+        channels[4][i] = normal.y();
+        channels[5][i] = normal.z();
+
+        channels[6][i] = depth(i);
+        channels[7][i] = m_materialIDs[i];
+    }
+
+    image.setChannel("albedo.R", channels[0]);
+    image.setChannel("albedo.G", channels[1]);
+    image.setChannel("albedo.B", channels[2]);
+    image.setChannel("normal.X", channels[3]);
+    image.setChannel("normal.Y", channels[4]);
+    image.setChannel("normal.Z", channels[5]);
+    image.setChannel("depth.Z", channels[6]);
+    image.setChannel("materialID", channels[7]);
+}
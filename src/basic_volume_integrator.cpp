@@ -33,7 +33,7 @@ Color BasicVolumeIntegrator::L(
     Color modulation = Color(1.f);
     MediumPtrVector mediumPtrs;
 
-    sample.eyePoints.push_back(intersection.point);
+    sample.recordEyePoint(intersection.point);
 
     const BSDFSample bsdfSample = intersection.material->sample(intersection, random);
     Interaction interaction({
@@ -52,7 +52,7 @@ Color BasicVolumeIntegrator::L(
             random,
             sample
         );
-        sample.contributions.push_back({result, 1.f});
+        sample.recordContribution({result, 1.f});
     }
 
     for (int bounce = 2; !m_bounceController.checkDone(bounce); bounce++) {
@@ -81,7 +81,7 @@ Color BasicVolumeIntegrator::L(
         // Update the current medium
         updateMediumPtrs(mediumPtrs, interaction);
 
-        sample.eyePoints.push_back(bounceIntersection.point);
+        sample.recordEyePoint(bounceIntersection.point);
 
         // Integrate any volumes,
         // possibly overriding the bounce point with a scatter point
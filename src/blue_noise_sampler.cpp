@@ -0,0 +1,193 @@
+#include "blue_noise_sampler.h"
+
+#include "low_discrepancy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static const int MaskSize = BlueNoiseSampler::MaskSize;
+static const int MaskArea = MaskSize * MaskSize;
+
+// Toroidal Gaussian energy around a point, indexed by offset
+static std::vector<float> buildKernel()
+{
+    const float sigma = 1.9f;
+
+    std::vector<float> kernel(MaskArea);
+    for (int y = 0; y < MaskSize; y++) {
+        for (int x = 0; x < MaskSize; x++) {
+            const int dx = std::min(x, MaskSize - x);
+            const int dy = std::min(y, MaskSize - y);
+            kernel[y * MaskSize + x] = std::exp(-(dx * dx + dy * dy) / (2.f * sigma * sigma));
+        }
+    }
+    return kernel;
+}
+
+class EnergyField {
+public:
+    EnergyField(const std::vector<float> &kernel)
+        : m_kernel(&kernel), m_energy(MaskArea, 0.f), m_points(MaskArea, false)
+    {}
+
+    void toggle(int index, bool value) {
+        m_points[index] = value;
+
+        const float sign = value ? 1.f : -1.f;
+        const int px = index % MaskSize;
+        const int py = index / MaskSize;
+        for (int y = 0; y < MaskSize; y++) {
+            const int ky = (y - py + MaskSize) % MaskSize;
+            for (int x = 0; x < MaskSize; x++) {
+                const int kx = (x - px + MaskSize) % MaskSize;
+                m_energy[y * MaskSize + x] += sign * (*m_kernel)[ky * MaskSize + kx];
+            }
+        }
+    }
+
+    int tightestCluster() const { return extreme(true); }
+    int largestVoid() const { return extreme(false); }
+
+    bool point(int index) const { return m_points[index]; }
+
+private:
+    int extreme(bool points) const {
+        int result = -1;
+        float best = points
+            ? -std::numeric_limits<float>::max()
+            : std::numeric_limits<float>::max();
+
+        for (int i = 0; i < MaskArea; i++) {
+            if (m_points[i] != points) { continue; }
+            if ((points && m_energy[i] > best) || (!points && m_energy[i] < best)) {
+                best = m_energy[i];
+                result = i;
+            }
+        }
+        return result;
+    }
+
+    const std::vector<float> *m_kernel;
+    std::vector<float> m_energy;
+    std::vector<bool> m_points;
+};
+
+// Ulichney's void-and-cluster method
+static std::vector<float> buildMask()
+{
+    const std::vector<float> kernel = buildKernel();
+    RandomGenerator random(0x626c7565, 0);
+
+    // Initial pattern: random minority points, relaxed until the tightest
+    // cluster is also the largest void
+    EnergyField prototype(kernel);
+    const int initialCount = MaskArea / 10;
+    for (int placed = 0; placed < initialCount;) {
+        const int index = std::min((int)(random.next() * MaskArea), MaskArea - 1);
+        if (prototype.point(index)) { continue; }
+
+        prototype.toggle(index, true);
+        placed++;
+    }
+
+    for (int iteration = 0; iteration < MaskArea; iteration++) {
+        const int cluster = prototype.tightestCluster();
+        prototype.toggle(cluster, false);
+
+        const int emptiest = prototype.largestVoid();
+        prototype.toggle(emptiest, true);
+
+        if (emptiest == cluster) { break; }
+    }
+
+    std::vector<int> ranks(MaskArea, 0);
+
+    // Phase 1: rank the initial points by removing tightest clusters
+    EnergyField field = prototype;
+    for (int rank = initialCount - 1; rank >= 0; rank--) {
+        const int cluster = field.tightestCluster();
+        field.toggle(cluster, false);
+        ranks[cluster] = rank;
+    }
+
+    // Phase 2: fill the largest voids up to half coverage
+    field = prototype;
+    for (int rank = initialCount; rank < MaskArea / 2; rank++) {
+        const int emptiest = field.largestVoid();
+        field.toggle(emptiest, true);
+        ranks[emptiest] = rank;
+    }
+
+    // Phase 3: the remaining empty cells are now the minority, so rank them
+    // by their own clustering
+    EnergyField inverted(kernel);
+    for (int i = 0; i < MaskArea; i++) {
+        if (!field.point(i)) { inverted.toggle(i, true); }
+    }
+    for (int rank = MaskArea / 2; rank < MaskArea; rank++) {
+        const int cluster = inverted.tightestCluster();
+        inverted.toggle(cluster, false);
+        ranks[cluster] = rank;
+    }
+
+    std::vector<float> mask(MaskArea);
+    for (int i = 0; i < MaskArea; i++) {
+        mask[i] = (ranks[i] + 0.5f) / MaskArea;
+    }
+    return mask;
+}
+
+const std::vector<float> &BlueNoiseSampler::mask()
+{
+    static const std::vector<float> mask = buildMask();
+    return mask;
+}
+
+BlueNoiseSampler::BlueNoiseSampler(uint64_t seed, int width)
+    : Sampler(seed),
+      m_width(width),
+      m_sequenceSeed(LowDiscrepancy::hash(seed ^ (seed >> 32)))
+{
+    mask();
+}
+
+// Each dimension reads the mask through its own toroidal shift (R2 sequence)
+// so that dimensions do not share a dither pattern
+float BlueNoiseSampler::offset(int dimension) const
+{
+    const float g = 1.32471795724474602596f;
+    const int shiftX = (int)(MaskSize * std::fmod(dimension / g, 1.f));
+    const int shiftY = (int)(MaskSize * std::fmod(dimension / (g * g), 1.f));
+
+    const int x = (m_pixelIndex % m_width + shiftX) % MaskSize;
+    const int y = (m_pixelIndex / m_width + shiftY) % MaskSize;
+    return mask()[y * MaskSize + x];
+}
+
+static float rotate(float value, float offset)
+{
+    const float rotated = value + offset;
+    return std::min(rotated >= 1.f ? rotated - 1.f : rotated, 0x1.fffffep-1f);
+}
+
+float BlueNoiseSampler::next()
+{
+    const int dimension = m_dimension++;
+    const uint32_t seed = LowDiscrepancy::hashCombine(m_sequenceSeed, dimension);
+
+    const float value = LowDiscrepancy::sobol1D(m_sampleIndex, seed);
+    return rotate(value, offset(2 * dimension));
+}
+
+std::array<float, 2> BlueNoiseSampler::next2D()
+{
+    const int dimension = m_dimension++;
+    const uint32_t seed = LowDiscrepancy::hashCombine(m_sequenceSeed, dimension);
+
+    const std::array<float, 2> values = LowDiscrepancy::sobol2D(m_sampleIndex, seed);
+    return {
+        rotate(values[0], offset(2 * dimension)),
+        rotate(values[1], offset(2 * dimension + 1))
+    };
+}
@@ -1,11 +1,11 @@
 #include "camera.h"
 
 #include "geometry.h"
+#include "random_generator.h"
 #include "ray.h"
 #include "vector.h"
 
 #include <cmath>
-#include <cstdlib>
 #include <iostream>
 #include <math.h>
 #include <stdio.h>
@@ -46,10 +46,11 @@ Ray Camera::generateRay(float row, float col) const
     return transformedRay;
 }
 
-Ray Camera::generateRay(int row, int col) const
+Ray Camera::generateRay(int row, int col, RandomGenerator &random) const
 {
-    float jitterX = (1.f * std::rand() / RAND_MAX) - 0.5f;
-    float jitterY = (1.f * std::rand() / RAND_MAX) - 0.5f;
+    const std::array<float, 2> xi = random.next2D();
+    float jitterX = xi[0] - 0.5f;
+    float jitterY = xi[1] - 0.5f;
 
     return generateRay(row + jitterY, col + jitterX);
 }
@@ -2,8 +2,10 @@
 
 #include "canvas.h"
 
+#include "globals.h"
+#include "image_writer.h"
+
 #include <iostream>
-#include <mutex>
 #include <vector>
 
 Canvas::Canvas(Widget *parent, Image &image, int width, int height)
@@ -81,10 +83,7 @@ void Canvas::init()
 
 void Canvas::syncTextureBuffer()
 {
-    std::mutex &lock = mImage.getLock();
-    lock.lock();
-
-    const std::vector<unsigned char> &renderedBuffer = mImage.data();
+    const std::vector<unsigned char> renderedBuffer = mImage.data();
 
     for (int row = 0; row < mHeight; row++) {
         for (int col = 0; col < mWidth; col++) {
@@ -98,8 +97,6 @@ void Canvas::syncTextureBuffer()
 
     glBindTexture(GL_TEXTURE_2D, mTextureID);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, mTextureWidth, mTextureHeight, 0, GL_RGB, GL_UNSIGNED_BYTE, mTextureBuffer.data());
-
-    lock.unlock();
 }
 
 void Canvas::drawGL()
@@ -131,5 +128,11 @@ void Canvas::drawGL()
 
 void Canvas::save(const std::string &filestem)
 {
-    mImage.save(filestem);
+    // Image::save would publish from the UI thread; write what's on screen
+    ImageWriter::write(
+        *mImage.snapshot(),
+        g_job->outputDirectory() + filestem,
+        false,
+        g_job->exrCompression()
+    );
 }
@@ -132,13 +132,14 @@ void DataParallelIntegrator::preprocess(const Scene &scene, RandomGenerator &ran
 void DataParallelIntegrator::generateInitialIntersections(
     int rows, int cols,
     const Scene &scene,
+    RandomGenerator &random,
     std::vector<Intersection> &intersections
 ) {
     for (int i = 0; i < rows * cols; i++) {
         int row = (int)floorf(i / cols);
         int col = i % cols;
 
-        Ray ray = scene.getCamera()->generateRay(row, col);
+        Ray ray = scene.getCamera()->generateRay(row, col, random);
 
         Intersection intersection = scene.testIntersect(ray);
         intersections[i] = intersection;
@@ -181,7 +182,7 @@ void DataParallelIntegrator::generatePhotonBundles(
             g_job->thetaSteps()
         );
 
-        std::vector<float> photonBundle = photonPDF.asVector(intersection.worldToTangent);
+        std::vector<float> photonBundle = photonPDF.asVector(intersection.frame().toLocalTransform());
 
         const int photonOffset = debugSearchCount * ((row * cols) + col);
         for (int j = 0; j < debugSearchCount; j++) {
@@ -221,7 +222,8 @@ std::vector<float> DataParallelIntegrator::visualizePDF(
 ) {
     const int debugSearchCount = g_job->debugSearchCount();
 
-    const Ray ray = scene.getCamera()->generateRay(row, col);
+    RandomGenerator random;
+    const Ray ray = scene.getCamera()->generateRay(row, col, random);
     const Intersection intersection = scene.testIntersect(ray);
 
     std::vector<Intersection> intersections = { intersection };
@@ -260,7 +262,7 @@ void DataParallelIntegrator::generateBounceIntersections(
         }
 
         Vector3 hemisphereSample = sphericalToCartesian(phis[i], thetas[i]);
-        Vector3 bounceDirection = intersection.tangentToWorld.apply(hemisphereSample);
+        Vector3 bounceDirection = intersection.frame().toWorld(hemisphereSample);
 
         Ray bounceRay(
             intersection.point,
@@ -305,10 +307,11 @@ void DataParallelIntegrator::calculateDirectLighting(
 }
 
 void DataParallelIntegrator::sampleImage(
-    std::vector<float> &radianceLookup,
-    std::vector<Sample> &sampleLookup,
+    Accumulator &accumulator,
+    SampleLookup &sampleLookup,
     Scene &scene,
-    RandomGenerator &random
+    RandomGenerator &random,
+    int sampleIndex
 ) {
     const int cols = g_job->width();
     const int rows = g_job->height();
@@ -323,7 +326,7 @@ void DataParallelIntegrator::sampleImage(
     std::vector<float> thetas(rows * cols, -1.f);
     std::vector<float> pdfs(rows * cols, -1.f);
 
-    generateInitialIntersections(rows, cols, scene, intersections);
+    generateInitialIntersections(rows, cols, scene, random, intersections);
 
     if (m_bounceController.checkCounts(1)) {
         calculateDirectLighting(
@@ -362,11 +365,6 @@ void DataParallelIntegrator::sampleImage(
     }
 
     for (int i = 0; i < rows * cols; i++) {
-        int row = (int)floorf(i / cols);
-        int col = i % cols;
-
-        radianceLookup[3 * (row * cols + col) + 0] += results[i].r();
-        radianceLookup[3 * (row * cols + col) + 1] += results[i].g();
-        radianceLookup[3 * (row * cols + col) + 2] += results[i].b();
+        accumulator.add(i, results[i]);
     }
 }
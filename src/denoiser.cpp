@@ -0,0 +1,142 @@
+#include "denoiser.h"
+
+#include "omp.h"
+
+#include <algorithm>
+#include <cmath>
+
+// B3 spline, the 5-tap kernel from the paper
+static const float Kernel[3] = { 3.f / 8.f, 1.f / 4.f, 1.f / 16.f };
+
+static const float LuminanceSigma = 4.f;
+static const float NormalPower = 128.f;
+static const float DepthSigma = 0.1f;
+
+// Below this albedo radiance is filtered as is
+static const float AlbedoFloor = 1e-3f;
+
+static Color demodulationFactor(const Color &albedo)
+{
+    return Color(
+        albedo.r() > AlbedoFloor ? albedo.r() : 1.f,
+        albedo.g() > AlbedoFloor ? albedo.g() : 1.f,
+        albedo.b() > AlbedoFloor ? albedo.b() : 1.f
+    );
+}
+
+Denoiser::Denoiser(int width, int height, int iterations)
+    : m_width(width),
+      m_height(height),
+      m_iterations(iterations),
+      m_radiance(width * height, Color(0.f)),
+      m_filtered(width * height, Color(0.f)),
+      m_variance(width * height, 0.f),
+      m_filteredVariance(width * height, 0.f),
+      m_albedo(width * height, Color(0.f)),
+      m_normal(width * height, Vector3(0.f)),
+      m_depth(width * height, 0.f)
+{}
+
+void Denoiser::setPixel(
+    int pixelIndex,
+    const Color &radiance,
+    float variance,
+    const Color &albedo,
+    const Vector3 &normal,
+    float depth
+) {
+    const Color factor = demodulationFactor(albedo);
+    const float luminanceFactor = factor.luminance();
+
+    m_radiance[pixelIndex] = radiance / factor;
+    m_variance[pixelIndex] = variance / (luminanceFactor * luminanceFactor);
+    m_albedo[pixelIndex] = albedo;
+    // Averaged normals come out short; the normal weight wants unit length
+    m_normal[pixelIndex] = normal.isZero() ? normal : normal.normalized();
+    m_depth[pixelIndex] = depth;
+}
+
+void Denoiser::setInput(const Accumulator &accumulator, const AOVBuffer &aovs)
+{
+    #pragma omp parallel for
+    for (int pixelIndex = 0; pixelIndex < m_width * m_height; pixelIndex++) {
+        setPixel(
+            pixelIndex,
+            accumulator.mean(pixelIndex),
+            accumulator.meanVariance(pixelIndex),
+            aovs.albedo(pixelIndex),
+            aovs.normal(pixelIndex),
+            aovs.depth(pixelIndex)
+        );
+    }
+}
+
+void Denoiser::denoise()
+{
+    for (int i = 0; i < m_iterations; i++) {
+        filterPass(1 << i);
+
+        std::swap(m_radiance, m_filtered);
+        std::swap(m_variance, m_filteredVariance);
+    }
+}
+
+Color Denoiser::output(int pixelIndex) const
+{
+    return m_radiance[pixelIndex] * demodulationFactor(m_albedo[pixelIndex]);
+}
+
+void Denoiser::filterPass(int step)
+{
+    #pragma omp parallel for schedule(dynamic, 4)
+    for (int row = 0; row < m_height; row++) {
+        for (int col = 0; col < m_width; col++) {
+            const int p = row * m_width + col;
+
+            const float luminanceP = m_radiance[p].luminance();
+            const float luminanceScale = LuminanceSigma * std::sqrt(m_variance[p]) + 1e-6f;
+            const Vector3 &normalP = m_normal[p];
+            const float depthScale = DepthSigma * step * m_depth[p] + 1e-6f;
+
+            Color sum(0.f);
+            float weightSum = 0.f;
+            float varianceSum = 0.f;
+
+            for (int dy = -2; dy <= 2; dy++) {
+                const int sampleRow = row + dy * step;
+                if (sampleRow < 0 || sampleRow >= m_height) { continue; }
+
+                for (int dx = -2; dx <= 2; dx++) {
+                    const int sampleCol = col + dx * step;
+                    if (sampleCol < 0 || sampleCol >= m_width) { continue; }
+
+                    const int q = sampleRow * m_width + sampleCol;
+
+                    const float luminanceWeight = std::abs(luminanceP - m_radiance[q].luminance())
+                        / luminanceScale;
+                    const float depthWeight = std::abs(m_depth[p] - m_depth[q]) / depthScale;
+
+                    // Misses have no normal; they only blend with each other
+                    const Vector3 &normalQ = m_normal[q];
+                    const float cosine = normalP.dot(normalQ);
+                    const bool bothMissed = normalP.isZero() && normalQ.isZero();
+                    const float normalWeight = bothMissed
+                        ? 1.f
+                        : std::pow(std::max(0.f, cosine), NormalPower);
+
+                    const float weight = Kernel[std::abs(dx)] * Kernel[std::abs(dy)]
+                        * normalWeight
+                        * std::exp(-luminanceWeight - depthWeight);
+
+                    sum += m_radiance[q] * weight;
+                    weightSum += weight;
+                    varianceSum += weight * weight * m_variance[q];
+                }
+            }
+
+            // The center tap always has weight, so weightSum > 0
+            m_filtered[p] = sum / weightSum;
+            m_filteredVariance[p] = varianceSum / (weightSum * weightSum);
+        }
+    }
+}
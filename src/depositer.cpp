@@ -200,14 +200,14 @@ Color Depositer::L(
     int pixelIndex,
     Sample &sample
 ) const {
-    sample.eyePoints.push_back(intersection.point);
+    sample.recordEyePoint(intersection.point);
 
     Color modulation = Color(1.f, 1.f, 1.f);
 
     Color result(0.f);
     if (m_bounceController.checkCounts(1)) {
         result = direct(intersection, modulation, scene, random, sample);
-        sample.contributions.push_back({result, 1.f});
+        sample.recordContribution({result, 1.f});
     }
 
     Intersection lastIntersection = intersection;
@@ -281,7 +281,7 @@ Color Depositer::L(
             lock.unlock();
         }
 
-        sample.eyePoints.push_back(bounceIntersection.point);
+        sample.recordEyePoint(bounceIntersection.point);
 
         Color f = lastIntersection.material->f(lastIntersection, bounceDirection);
         float invPDF = 1.f / pdf;
@@ -295,7 +295,7 @@ Color Depositer::L(
 
         result += direct(bounceIntersection, modulation, scene, random, sample);
 
-        sample.contributions.push_back({result - previous, invPDF});
+        sample.recordContribution({result - previous, invPDF});
     }
 
     return result;
@@ -324,7 +324,7 @@ Color Depositer::direct(
     Vector3 wo = lightDirection.normalized();
 
     if (lightSample.normal.dot(wo) >= 0.f) {
-        sample.shadowTests.push_back({
+        sample.recordShadowTest({
             intersection.point,
             lightSample.point,
             true
@@ -337,7 +337,7 @@ Color Depositer::direct(
     float lightDistance = lightDirection.length();
     bool occluded = scene.testOcclusion(shadowRay, lightDistance);
 
-    sample.shadowTests.push_back({
+    sample.recordShadowTest({
         intersection.point,
         lightSample.point,
         occluded
@@ -90,7 +90,7 @@ static Color directSampleLights(
 
     if (lightSample.normal.dot(wiWorld) >= 0.f) {
         // Sample hit back of light
-        sample.shadowTests.push_back({
+        sample.recordShadowTest({
             intersection.point,
             lightSample.point,
             true
@@ -103,7 +103,7 @@ static Color directSampleLights(
     const float lightDistance = lightDirection.length();
     OcclusionResult occlusionResult = scene.testVolumetricOcclusion(shadowRay, lightDistance);
 
-    sample.shadowTests.push_back({
+    sample.recordShadowTest({
         intersection.point,
         lightSample.point,
         occlusionResult.isOccluded
@@ -12,8 +12,9 @@ GGX::GGX(float alpha)
 
 Vector3 GGX::sampleWh(const Vector3 &wo, RandomGenerator &random) const
 {
-    const float xi1 = random.next();
-    const float xi2 = random.next();
+    const std::array<float, 2> xi = random.next2D();
+    const float xi1 = xi[0];
+    const float xi2 = xi[1];
 
     const float numerator = m_alpha * std::sqrt(xi1);
     const float denominator = std::sqrt(1.f - xi1);
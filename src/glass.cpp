@@ -32,7 +32,7 @@ BSDFSample Glass::sample(
     RandomGenerator &random
 ) const
 {
-    Vector3 localWo = intersection.worldToTangent.apply(intersection.woWorld);
+    Vector3 localWo = intersection.frame().toLocal(intersection.woWorld);
     Vector3 localWi(0.f);
 
     float etaIncident = 1.f;
@@ -58,7 +58,7 @@ BSDFSample Glass::sample(
         localWi = localWo.reflect(Vector3(0.f, 1.f, 0.f));
 
         BSDFSample sample = {
-            .wiWorld = intersection.tangentToWorld.apply(localWi),
+            .wiWorld = intersection.frame().toWorld(localWi),
             .pdf = fresnelReflectance,
             .throughput = Color(fresnelReflectance / TangentFrame::absCosTheta(localWi)),
             .material = this
@@ -74,7 +74,7 @@ BSDFSample Glass::sample(
         const float fresnelTransmittance = 1.f - fresnelReflectance;
 
         BSDFSample sample = {
-            .wiWorld = intersection.tangentToWorld.apply(localWi),
+            .wiWorld = intersection.frame().toWorld(localWi),
             .pdf = fresnelTransmittance,
             .throughput = Color(fresnelTransmittance / TangentFrame::absCosTheta(localWi)),
             .material = this
@@ -2,6 +2,7 @@
 
 #include "aabb.h"
 #include "regular_tracker.h"
+#include "render_stats.h"
 #include "scene.h"
 #include "volume_helper.h"
 #include "util.h"
@@ -103,8 +104,11 @@ Color GridMedium::transmittance(const Point3 &entryPointWorld, const Point3 &exi
         (hit.exitPoint - hit.enterPoint).toVector().normalized()
     );
 
+    int steps = 0;
     auto stepResult = trackerState.step();
     while(stepResult.isValidStep) {
+        steps += 1;
+
         const float midpointTime = (stepResult.enterTime + stepResult.currentTime) / 2.f;
         const Point3 midpointModel = trackerRay.at(midpointTime);
         const float midpointSigmaT = sigmaT(midpointModel, GridFrame::Model);
@@ -119,6 +123,8 @@ Color GridMedium::transmittance(const Point3 &entryPointWorld, const Point3 &exi
         stepResult = trackerState.step();
     }
 
+    RenderStats::local().mediumSteps += steps;
+
     return util::exp(-accumulatedExponent);
 }
 
@@ -141,8 +147,11 @@ TransmittanceQueryResult GridMedium::findTransmittance(
         (exitPointWorld - entryPointWorld).toVector().normalized()
     );
 
+    int steps = 0;
     auto stepResult = trackerState.step();
     while(stepResult.isValidStep) {
+        steps += 1;
+
         const float midpointTime = (stepResult.enterTime + stepResult.currentTime) / 2.f;
         const Point3 midpointWorld = trackerRay.at(midpointTime);
         const float midpointSigmaT = sigmaT(midpointWorld);
@@ -151,6 +160,8 @@ TransmittanceQueryResult GridMedium::findTransmittance(
         accumulatedExponent += cellExponent;
 
         if (accumulatedExponent >= targetExponent) {
+            RenderStats::local().mediumSteps += steps;
+
             const float overflow = accumulatedExponent - targetExponent;
             const float cellRatio = 1.f - overflow / cellExponent;
             const float actualCellTime = stepResult.cellTime * cellRatio;
@@ -164,6 +175,8 @@ TransmittanceQueryResult GridMedium::findTransmittance(
         stepResult = trackerState.step();
     }
 
+    RenderStats::local().mediumSteps += steps;
+
     return TransmittanceQueryResult({ false, -1.f });
 }
 
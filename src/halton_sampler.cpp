@@ -0,0 +1,47 @@
+#include "halton_sampler.h"
+
+#include "low_discrepancy.h"
+
+#include <algorithm>
+
+static const int Primes[] = {
+    2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53,
+    59, 61, 67, 71, 73, 79, 83, 89, 97, 101, 103, 107, 109, 113, 127, 131,
+    137, 139, 149, 151, 157, 163, 167, 173, 179, 181, 191, 193, 197, 199, 211, 223,
+    227, 229, 233, 239, 241, 251, 257, 263, 269, 271, 277, 281, 283, 293, 307, 311
+};
+static const int PrimeCount = sizeof(Primes) / sizeof(Primes[0]);
+
+HaltonSampler::HaltonSampler(uint64_t seed)
+    : Sampler(seed),
+      m_pixelSeed(0)
+{}
+
+void HaltonSampler::startPixelSample(int pixelIndex, int sampleIndex)
+{
+    Sampler::startPixelSample(pixelIndex, sampleIndex);
+
+    m_pixelSeed = LowDiscrepancy::hashCombine(
+        LowDiscrepancy::hash(m_seed ^ (m_seed >> 32)),
+        pixelIndex
+    );
+}
+
+uint64_t HaltonSampler::streamPosition(int dimension) const
+{
+    return std::max(0, dimension - PrimeCount);
+}
+
+float HaltonSampler::next()
+{
+    const int dimension = m_dimension++;
+    if (dimension >= PrimeCount) {
+        return RandomGenerator::next();
+    }
+
+    return LowDiscrepancy::scrambledRadicalInverse(
+        Primes[dimension],
+        m_sampleIndex,
+        LowDiscrepancy::hashCombine(m_pixelSeed, dimension)
+    );
+}
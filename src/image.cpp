@@ -1,64 +1,127 @@
 #include "image.h"
 
 #include "globals.h"
+#include "image_writer.h"
 
 #include "stb_image_write.h"
 #include "tinyexr.h"
 
-#include <iomanip>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <sstream>
 #include <stdlib.h>
 #include <string>
 
+// Gamma table over floats in [2^-18, 1), indexed by the exponent and the top
+// eight mantissa bits. Darker values all round to 0 and brighter ones to 255.
+static const uint32_t GammaMinBits = 109u << 23; // 2^-18
+static const int GammaMantissaShift = 15;
+static const int GammaTableSize = (18 << 23) >> GammaMantissaShift;
+
+static const std::array<unsigned char, GammaTableSize> &gammaTable()
+{
+    static const std::array<unsigned char, GammaTableSize> table = [] {
+        std::array<unsigned char, GammaTableSize> table;
+        for (int i = 0; i < GammaTableSize; i++) {
+            // Middle of the bucket
+            const uint32_t bits = GammaMinBits
+                + ((uint32_t)i << GammaMantissaShift)
+                + (1u << (GammaMantissaShift - 1));
+
+            float value;
+            memcpy(&value, &bits, sizeof(float));
+            table[i] = fminf(powf(value, 1/2.2), 1.f) * 255;
+        }
+        return table;
+    }();
+    return table;
+}
+
+static unsigned char gammaByte(float value, const std::array<unsigned char, GammaTableSize> &table)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(float));
+
+    // Negative values and NaNs fail the first test
+    if (!(value >= 0x1p-18f)) { return 0; }
+    if (value >= 1.f) { return 255; }
+
+    return table[(bits - GammaMinBits) >> GammaMantissaShift];
+}
+
 Image::Image(int width, int height)
     : m_height(height),
       m_width(width),
-      m_spp(0),
-      m_data(3 * m_height * m_width),
-      m_raw(3 * m_height * m_width)
-{}
+      m_back(std::make_shared<ImageSnapshot>())
+{
+    m_back->width = width;
+    m_back->height = height;
+    m_back->spp = 0;
+    m_back->raw.resize(3 * width * height, 0.f);
+
+    m_front = std::make_shared<const ImageSnapshot>(*m_back);
+}
 
 void Image::set(int row, int col, float r, float g, float b)
 {
+    std::vector<float> &raw = m_back->raw;
+
     // tinyexr is bottom to top
-    m_raw[3 * ((m_height - row - 1) * m_width + col) + 0] = r;
-    m_raw[3 * ((m_height - row - 1) * m_width + col) + 1] = g;
-    m_raw[3 * ((m_height - row - 1) * m_width + col) + 2] = b;
+    raw[3 * ((m_height - row - 1) * m_width + col) + 0] = r;
+    raw[3 * ((m_height - row - 1) * m_width + col) + 1] = g;
+    raw[3 * ((m_height - row - 1) * m_width + col) + 2] = b;
+}
 
-    unsigned char byteR = fminf(powf(r, 1/2.2), 1.f) * 255;
-    unsigned char byteG = fminf(powf(g, 1/2.2), 1.f) * 255;
-    unsigned char byteB = fminf(powf(b, 1/2.2), 1.f) * 255;
+void Image::publish()
+{
+    // The next frame starts from this one, since callers may only update
+    // part of it
+    std::shared_ptr<const ImageSnapshot> frame = m_back;
+    m_back = std::make_shared<ImageSnapshot>(*frame);
 
-    m_data[3 * (row * m_width + col) + 0] = byteR;
-    m_data[3 * (row * m_width + col) + 1] = byteG;
-    m_data[3 * (row * m_width + col) + 2] = byteB;
+    std::atomic_store(&m_front, frame);
+}
+
+std::shared_ptr<const ImageSnapshot> Image::snapshot() const
+{
+    return std::atomic_load(&m_front);
+}
+
+std::vector<unsigned char> Image::data() const
+{
+    const std::shared_ptr<const ImageSnapshot> frame = snapshot();
+    const auto &table = gammaTable();
+
+    std::vector<unsigned char> bytes(3 * m_width * m_height);
+    for (int row = 0; row < m_height; row++) {
+        const float *source = &frame->raw[3 * (m_height - row - 1) * m_width];
+        unsigned char *target = &bytes[3 * row * m_width];
+        for (int i = 0; i < 3 * m_width; i++) {
+            target[i] = gammaByte(source[i], table);
+        }
+    }
+    return bytes;
 }
 
 void Image::debug()
 {
+    const std::vector<unsigned char> bytes = data();
     for (int row = 0; row < m_height; row++) {
         for (int col = 0; col < m_width; col++) {
             printf(
                 "(%d,%d,%d) ",
-                (unsigned char)m_data[3 * (row * m_width + col) + 0],
-                (unsigned char)m_data[3 * (row * m_width + col) + 1],
-                (unsigned char)m_data[3 * (row * m_width + col) + 2]
+                bytes[3 * (row * m_width + col) + 0],
+                bytes[3 * (row * m_width + col) + 1],
+                bytes[3 * (row * m_width + col) + 2]
             );
         }
         printf("\n");
     }
 }
 
-const std::vector<unsigned char> &Image::data()
-{
-    return m_data;
-}
-
-std::mutex &Image::getLock()
-{
-    return m_lock;
-}
-
 std::string Image::pathFromFilename(const std::string &filename)
 {
     std::string outputDirectory = g_job->outputDirectory();
@@ -67,6 +130,21 @@ std::string Image::pathFromFilename(const std::string &filename)
     return outputExrStream.str();
 }
 
+void Image::setChannel(const std::string &name, const std::vector<float> &values)
+{
+    std::vector<float> &channel = m_back->channels[name];
+    channel.resize(m_width * m_height);
+
+    // Same flip as set
+    for (int row = 0; row < m_height; row++) {
+        std::copy(
+            values.begin() + row * m_width,
+            values.begin() + (row + 1) * m_width,
+            channel.begin() + (m_height - row - 1) * m_width
+        );
+    }
+}
+
 void Image::save(const std::string &filestem)
 {
     save(filestem, false);
@@ -79,83 +157,51 @@ void Image::saveCheckpoint(const std::string &filestem)
 
 void Image::save(const std::string &filestem, bool saveCheckpoint)
 {
-    EXRHeader header;
-    InitEXRHeader(&header);
-
-    EXRImage image;
-    InitEXRImage(&image);
-
-    image.num_channels = 3;
-
-    std::vector<float> images[3];
-    images[0].resize(m_width * m_height);
-    images[1].resize(m_width * m_height);
-    images[2].resize(m_width * m_height);
-
-    for (int i = 0; i < m_width * m_height; i++) {
-        images[0][i] = m_raw[3 * i + 0];
-        images[1][i] = m_raw[3 * i + 1];
-        images[2][i] = m_raw[3 * i + 2];
-    }
-
-    float* image_ptr[3];
-    image_ptr[0] = &(images[2].at(0)); // B
-    image_ptr[1] = &(images[1].at(0)); // G
-    image_ptr[2] = &(images[0].at(0)); // R
-
-    image.images = (unsigned char**)image_ptr;
-    image.width = m_width;
-    image.height = m_height;
-
-    header.num_channels = 3;
-    header.channels = (EXRChannelInfo *)malloc(sizeof(EXRChannelInfo) * header.num_channels);
-
-    // Must be BGR(A) order, since most of EXR viewers expect this channel order.
-    strncpy(header.channels[0].name, "B", 255); header.channels[0].name[strlen("B")] = '\0';
-    strncpy(header.channels[1].name, "G", 255); header.channels[1].name[strlen("G")] = '\0';
-    strncpy(header.channels[2].name, "R", 255); header.channels[2].name[strlen("R")] = '\0';
-
-    header.pixel_types = (int *)malloc(sizeof(int) * header.num_channels);
-    header.requested_pixel_types = (int *)malloc(sizeof(int) * header.num_channels);
-    for (int i = 0; i < header.num_channels; i++) {
-        header.pixel_types[i] = TINYEXR_PIXELTYPE_FLOAT; // pixel type of input image
-        header.requested_pixel_types[i] = TINYEXR_PIXELTYPE_HALF; // pixel type of output image to be stored in .EXR
-    }
-
-    const char *err;
-
-    std::string outputExr = pathFromFilename(filestem + ".exr");
+    publish();
+
+    ImageWriter::write(
+        *snapshot(),
+        g_job->outputDirectory() + filestem,
+        saveCheckpoint,
+        g_job->exrCompression()
+    );
+}
 
-    std::ostringstream outputSppExrStream;
-    outputSppExrStream << filestem << "-"
-                       << std::setfill('0') << std::setw(5) << m_spp
-                       << "spp.exr";
-    std::string outputSppExr = pathFromFilename(outputSppExrStream.str());
+bool Image::load(const std::string &path)
+{
+    float *rgba;
+    int width, height;
+    const char *err = nullptr;
 
-    int ret = SaveEXRImageToFile(&image, &header, outputExr.c_str(), &err);
+    int ret = LoadEXR(&rgba, &width, &height, path.c_str(), &err);
     if (ret != TINYEXR_SUCCESS) {
-        fprintf(stderr, "Save EXR err: %s\n", err);
-        return;
+        fprintf(stderr, "Load EXR err: %s\n", err ? err : "unknown");
+        if (err) { FreeEXRErrorMessage(err); }
+        return false;
     }
-    printf("Saved exr file. [ %s ] \n", outputExr.c_str());
 
-    if (saveCheckpoint) {
-        ret = SaveEXRImageToFile(&image, &header, outputSppExr.c_str(), &err);
-        if (ret != TINYEXR_SUCCESS) {
-            fprintf(stderr, "Save EXR err: %s\n", err);
-            return;
+    const bool matches = width == m_width && height == m_height;
+    if (matches) {
+        // Both are bottom row first
+        std::vector<float> &raw = m_back->raw;
+        for (int i = 0; i < m_width * m_height; i++) {
+            raw[3 * i + 0] = rgba[4 * i + 0];
+            raw[3 * i + 1] = rgba[4 * i + 1];
+            raw[3 * i + 2] = rgba[4 * i + 2];
         }
-        printf("Saved exr file. [ %s ] \n", outputSppExr.c_str());
+    } else {
+        fprintf(stderr, "Load EXR err: %s is %dx%d\n", path.c_str(), width, height);
     }
 
-    free(header.channels);
-    free(header.pixel_types);
-    free(header.requested_pixel_types);
+    free(rgba);
+    return matches;
 }
 
 void Image::write(const std::string &filename)
 {
+    publish();
+
     std::string path = pathFromFilename(filename);
 
-    stbi_write_bmp(path.c_str(), m_width, m_height, 3, m_data.data());
+    stbi_write_bmp(path.c_str(), m_width, m_height, 3, data().data());
 }
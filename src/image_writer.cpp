@@ -0,0 +1,196 @@
+#include "image_writer.h"
+
+#include "trace.h"
+
+#include "tinyexr.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static bool writeFile(const std::string &path, const unsigned char *data, size_t size)
+{
+    const std::string temporaryPath = path + ".tmp";
+
+    FILE *file = fopen(temporaryPath.c_str(), "wb");
+    if (!file) { return false; }
+
+    const bool written = fwrite(data, 1, size, file) == size;
+    const bool closed = fclose(file) == 0;
+    if (!written || !closed) {
+        remove(temporaryPath.c_str());
+        return false;
+    }
+
+    return rename(temporaryPath.c_str(), path.c_str()) == 0;
+}
+
+ImageWriter::ImageWriter(const std::string &directory, int capacity, int compression)
+    : m_directory(directory),
+      m_capacity(std::max(1, capacity)),
+      m_compression(compression),
+      m_writing(false),
+      m_stopping(false),
+      m_thread(&ImageWriter::drain, this)
+{}
+
+ImageWriter::~ImageWriter()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_stopping = true;
+    }
+    m_changed.notify_all();
+    m_thread.join();
+}
+
+void ImageWriter::save(
+    std::shared_ptr<const ImageSnapshot> snapshot,
+    const std::string &filestem,
+    bool checkpoint
+) {
+    std::unique_lock<std::mutex> guard(m_lock);
+    m_changed.wait(guard, [this] { return (int)m_queue.size() < m_capacity; });
+
+    m_queue.push_back({ snapshot, filestem, checkpoint });
+    m_changed.notify_all();
+}
+
+void ImageWriter::flush()
+{
+    std::unique_lock<std::mutex> guard(m_lock);
+    m_changed.wait(guard, [this] { return m_queue.empty() && !m_writing; });
+}
+
+void ImageWriter::drain()
+{
+    std::unique_lock<std::mutex> guard(m_lock);
+    while (true) {
+        m_changed.wait(guard, [this] { return !m_queue.empty() || m_stopping; });
+        if (m_queue.empty()) { return; }
+
+        Request request = m_queue.front();
+        m_queue.pop_front();
+        m_writing = true;
+        m_changed.notify_all();
+
+        guard.unlock();
+        write(
+            *request.snapshot,
+            m_directory + request.filestem,
+            request.checkpoint,
+            m_compression
+        );
+        guard.lock();
+
+        m_writing = false;
+        m_changed.notify_all();
+    }
+}
+
+bool ImageWriter::write(
+    const ImageSnapshot &snapshot,
+    const std::string &pathStem,
+    bool checkpoint,
+    int compression
+) {
+    Trace::Scope saveScope(checkpoint ? "saveCheckpoint" : "save", pathStem);
+
+    const int width = snapshot.width;
+    const int height = snapshot.height;
+
+    EXRHeader header;
+    InitEXRHeader(&header);
+
+    EXRImage image;
+    InitEXRImage(&image);
+
+    const int channelCount = 3 + snapshot.channels.size();
+    image.num_channels = channelCount;
+
+    std::vector<float> images[3];
+    images[0].resize(width * height);
+    images[1].resize(width * height);
+    images[2].resize(width * height);
+
+    for (int i = 0; i < width * height; i++) {
+        images[0][i] = snapshot.raw[3 * i + 0];
+        images[1][i] = snapshot.raw[3 * i + 1];
+        images[2][i] = snapshot.raw[3 * i + 2];
+    }
+
+    // Must be BGR(A) order, since most of EXR viewers expect this channel
+    // order. The extra channels follow, already sorted by name.
+    std::vector<const char *> names = { "B", "G", "R" };
+    std::vector<const float *> image_ptr = {
+        &(images[2].at(0)),
+        &(images[1].at(0)),
+        &(images[0].at(0))
+    };
+    for (const auto &channel : snapshot.channels) {
+        names.push_back(channel.first.c_str());
+        image_ptr.push_back(channel.second.data());
+    }
+
+    image.images = (unsigned char**)image_ptr.data();
+    image.width = width;
+    image.height = height;
+
+    header.compression_type = compression;
+    header.num_channels = channelCount;
+    header.channels = (EXRChannelInfo *)malloc(sizeof(EXRChannelInfo) * header.num_channels);
+
+    for (int i = 0; i < header.num_channels; i++) {
+        strncpy(header.channels[i].name, names[i], 255);
+        header.channels[i].name[255] = '\0';
+    }
+
+    header.pixel_types = (int *)malloc(sizeof(int) * header.num_channels);
+    header.requested_pixel_types = (int *)malloc(sizeof(int) * header.num_channels);
+    for (int i = 0; i < header.num_channels; i++) {
+        header.pixel_types[i] = TINYEXR_PIXELTYPE_FLOAT; // pixel type of input image
+
+        // Radiance fits in half; depth and IDs don't
+        header.requested_pixel_types[i] = i < 3 ? TINYEXR_PIXELTYPE_HALF : TINYEXR_PIXELTYPE_FLOAT;
+    }
+
+    // Encode once, write every copy from memory
+    unsigned char *memory = nullptr;
+    const char *err = nullptr;
+    const size_t size = SaveEXRImageToMemory(&image, &header, &memory, &err);
+
+    free(header.channels);
+    free(header.pixel_types);
+    free(header.requested_pixel_types);
+
+    if (size == 0) {
+        fprintf(stderr, "Save EXR err: %s\n", err ? err : "unknown");
+        if (err) { FreeEXRErrorMessage(err); }
+        return false;
+    }
+
+    std::vector<std::string> paths = { pathStem + ".exr" };
+    if (checkpoint) {
+        std::ostringstream sppStream;
+        sppStream << pathStem << "-"
+                  << std::setfill('0') << std::setw(5) << snapshot.spp
+                  << "spp.exr";
+        paths.push_back(sppStream.str());
+    }
+
+    bool success = true;
+    for (const std::string &path : paths) {
+        if (writeFile(path, memory, size)) {
+            printf("Saved exr file. [ %s ] \n", path.c_str());
+        } else {
+            fprintf(stderr, "Save EXR err: failed to write %s\n", path.c_str());
+            success = false;
+        }
+    }
+
+    free(memory);
+    return success;
+}
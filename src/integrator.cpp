@@ -1,20 +1,62 @@
 #include "integrator.h"
 
 #include "camera.h"
+#include "denoiser.h"
 #include "globals.h"
+#include "image_writer.h"
 #include "job.h"
 #include "logger.h"
 #include "ray.h"
+#include "render_stats.h"
+#include "tile_scheduler.h"
+#include "trace.h"
 
 #include <omp.h>
 
-#include <ctime>
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <iomanip>
 #include <memory>
 #include <mutex>
 #include <sstream>
 #include <stdio.h>
+#include <string>
+
+static void saveDenoised(
+    const Accumulator &accumulator,
+    const AOVBuffer &aovs,
+    const Tile &cropWindow,
+    int spp,
+    bool checkpoint,
+    ImageWriter &writer
+) {
+    Trace::Scope denoiseScope("denoise");
+
+    const int width = accumulator.width();
+    const int height = accumulator.height();
+
+    Denoiser denoiser(width, height, g_job->denoiseIterations());
+    denoiser.setInput(accumulator, aovs);
+    denoiser.denoise();
+
+    Image image(width, height);
+    if (!g_job->cropComposite().empty()) {
+        image.load(g_job->cropComposite());
+    }
+
+    for (int row = cropWindow.startRow; row < cropWindow.endRow; row++) {
+        for (int col = cropWindow.startCol; col < cropWindow.endCol; col++) {
+            const Color denoised = denoiser.output(row * width + col);
+            image.set(row, col, denoised.r(), denoised.g(), denoised.b());
+        }
+    }
+
+    image.setSpp(spp);
+    image.publish();
+
+    writer.save(image.snapshot(), g_job->outputStem() + "-denoised", checkpoint);
+}
 
 void Integrator::run(Image &image, Scene &scene, std::function<void(RenderStatus)> callback, bool *quit)
 {
@@ -22,38 +64,135 @@ void Integrator::run(Image &image, Scene &scene, std::function<void(RenderStatus
     const int height = g_job->height();
 
     const int primarySamples = g_job->spp();
+    const double timeBudgetSeconds = g_job->timeBudgetSeconds();
+
+    // Wall time: clock() sums CPU time over every render thread
+    const auto renderBegin = std::chrono::steady_clock::now();
+    auto elapsedSince = [](std::chrono::steady_clock::time_point begin) {
+        const auto now = std::chrono::steady_clock::now();
+        return std::chrono::duration<double>(now - begin).count();
+    };
+
+    Accumulator accumulator(width, height);
+    const uint64_t checkpointHash = g_job->checkpointHash();
+
+    // A crop window, and for distributed workers their tile range, limit
+    // the pixels that are rendered; integrators that honour the active mask
+    // skip the rest. Tile ranges count tiles of the crop window.
+    const Tile cropWindow = g_job->cropWindow();
+    if (g_job->hasCrop() || g_job->hasTileRange()) {
+        std::vector<uint8_t> owned(width * height, false);
+
+        TileScheduler scheduler(cropWindow, g_job->tileSize());
+        const int tileBegin = g_job->hasTileRange() ? g_job->tileRangeBegin() : 0;
+        const int tileEnd = g_job->hasTileRange()
+            ? std::min(g_job->tileRangeEnd(), scheduler.tileCount())
+            : scheduler.tileCount();
+        for (int tileIndex = tileBegin; tileIndex < tileEnd; tileIndex++) {
+            const Tile &tile = scheduler.tile(tileIndex);
+            for (int row = tile.startRow; row < tile.endRow; row++) {
+                for (int col = tile.startCol; col < tile.endCol; col++) {
+                    owned[row * width + col] = true;
+                }
+            }
+        }
 
-    RandomGenerator random;
+        for (int pixelIndex = 0; pixelIndex < width * height; pixelIndex++) {
+            if (!owned[pixelIndex]) { accumulator.deactivate(pixelIndex); }
+        }
+    }
+
+    int firstPass = 0;
+    if (g_job->resume()) {
+        // Pixel sample streams are keyed on the seed and sample counts, so
+        // restoring both continues every pixel's sequence where it stopped
+        CheckpointInfo info;
+        if (accumulator.loadCheckpoint(g_job->checkpointPath(), checkpointHash, &info)) {
+            g_job->restoreSeed(info.seed);
+            firstPass = info.passes;
+
+            Logger::line("resuming after " + std::to_string(firstPass) + " samples");
+        } else {
+            Logger::line("no checkpoint matching this job, starting over");
+        }
+    }
+
+    // The denoiser is guided by the same buffers
+    m_aovBuffer.reset();
+    if (g_job->aovs() || g_job->denoise()) {
+        m_aovBuffer = std::make_unique<AOVBuffer>(width, height);
+        m_aovBuffer->assignMaterialIDs(scene.getSurfaces());
+    }
+
+    // Pixels own streams [0, width * height), keep clear of them
+    RandomGenerator random(g_job->seed(), width * height);
 
     {
         printf("Beginning pre-process...\n");
-        std::clock_t begin = clock();
+        Trace::Scope preprocessScope("preprocess");
+
+        const auto begin = std::chrono::steady_clock::now();
         preprocess(scene, random);
-        std::clock_t end = clock();
-        double elapsedSeconds = double(end - begin) / CLOCKS_PER_SEC;
+        const double elapsedSeconds = elapsedSince(begin);
         printf("Pre-process complete (%0.1fs elapsed)\n", elapsedSeconds);
     }
 
-    std::vector<float> radianceLookup(3 * width * height);
-    for (int i = 0; i < 3 * width * height; i++) {
-        radianceLookup[i] = 0.f;
+    // Declared before anything that returns early, so every queued EXR is
+    // on disk by the time run returns
+    ImageWriter writer(
+        g_job->outputDirectory(),
+        g_job->writerQueueSize(),
+        g_job->exrCompression()
+    );
+
+    // Only count rays traced by the passes themselves
+    RenderStats::collect();
+    RenderCounters renderCounters;
+    double sampleSeconds = 0.0;
+
+    if (!g_job->cropComposite().empty()) {
+        if (!image.load(g_job->cropComposite())) {
+            Logger::line("failed to composite onto " + g_job->cropComposite());
+        }
+    }
+
+    for (int pixelIndex : g_job->debugPixels()) {
+        captureSamples(pixelIndex);
     }
 
-    for (int i = 0; i < primarySamples; i++) {
-        std::clock_t begin = clock();
+    const float adaptiveThreshold = g_job->adaptiveThreshold();
+    const bool adaptive = adaptiveThreshold > 0.f && adaptiveSampling();
+    const int adaptiveMinSpp = g_job->adaptiveMinSpp();
 
-        auto sampleLookup = std::make_shared<std::vector<Sample> >(width * height);
-        sampleImage(
-            radianceLookup,
-            *sampleLookup,
-            scene,
-            random
-        );
+    for (int i = firstPass; i < primarySamples; i++) {
+        const auto begin = std::chrono::steady_clock::now();
+
+        auto sampleLookup = std::make_shared<SampleLookup>(emptySampleLookup());
+        {
+            Trace::Scope passScope("pass", std::to_string(i + 1));
+            sampleImage(
+                accumulator,
+                *sampleLookup,
+                scene,
+                random,
+                i
+            );
+        }
 
-        std::clock_t end = clock();
+        const double elapsedSeconds = elapsedSince(begin);
 
         postwave(scene, random, i + 1);
 
+        const RenderCounters passCounters = RenderStats::collect();
+        renderCounters.merge(passCounters);
+        sampleSeconds += elapsedSeconds;
+
+        int activePixels = (cropWindow.endRow - cropWindow.startRow)
+            * (cropWindow.endCol - cropWindow.startCol);
+        if (adaptive) {
+            activePixels = accumulator.updateConvergence(adaptiveThreshold, adaptiveMinSpp);
+        }
+
         RenderStatus renderStatus;
         renderStatus.setSample(i + 1);
         renderStatus.setSampleLookup(sampleLookup);
@@ -66,41 +205,125 @@ void Integrator::run(Image &image, Scene &scene, std::function<void(RenderStatus
 
         callback(renderStatus);
 
-        std::mutex &lock = image.getLock();
-        lock.lock();
-
         image.setSpp(i + 1);
 
-        for (int row = 0; row < height; row++) {
-            for (int col = 0; col < width; col++) {
-                int index = 3 * (row * width + col);
-                image.set(
-                    row,
-                    col,
-                    radianceLookup[index + 0] / (i + 1),
-                    radianceLookup[index + 1] / (i + 1),
-                    radianceLookup[index + 2] / (i + 1)
-                );
+        for (int row = cropWindow.startRow; row < cropWindow.endRow; row++) {
+            for (int col = cropWindow.startCol; col < cropWindow.endCol; col++) {
+                const Color mean = accumulator.mean(row * width + col);
+                image.set(row, col, mean.r(), mean.g(), mean.b());
             }
         }
 
+        if (g_job->aovs()) {
+            m_aovBuffer->write(image);
+
+            std::vector<float> sampleCounts(width * height);
+            for (int pixelIndex = 0; pixelIndex < width * height; pixelIndex++) {
+                sampleCounts[pixelIndex] = accumulator.sampleCount(pixelIndex);
+            }
+            image.setChannel("sampleCount", sampleCounts);
+        }
+
+        // The display and the EXR writer only ever see whole frames
+        image.publish();
+
+        const CheckpointInfo checkpointInfo = { checkpointHash, g_job->seed(), i + 1 };
+
         int maxJ = log2f(primarySamples);
         for (int j = 0; j <= maxJ; j++) {
             if (1 << j == i + 1) {
-                image.saveCheckpoint("auto");
+                writer.save(image.snapshot(), g_job->outputStem(), true);
+
+                if (g_job->denoise() && g_job->denoiseCheckpoints()) {
+                    saveDenoised(accumulator, *m_aovBuffer, cropWindow, i + 1, true, writer);
+                }
+
+                Trace::Scope checkpointScope("saveAccumulator");
+                if (!accumulator.saveCheckpoint(g_job->checkpointPath(), checkpointInfo)) {
+                    Logger::line("failed to write " + g_job->checkpointPath());
+                }
             }
         }
 
-        lock.unlock();
-        double elapsedSeconds = double(end - begin) / CLOCKS_PER_SEC;
+        const bool converged = activePixels == 0;
+        const bool lastPass = i + 1 == primarySamples;
+
+        // Assume the next pass costs as much as this one, including the
+        // image update and any checkpoint
+        const double renderSeconds = elapsedSince(renderBegin);
+        const double passSeconds = elapsedSince(begin);
+        const bool outOfTime = timeBudgetSeconds > 0.0
+            && !lastPass
+            && renderSeconds + passSeconds > timeBudgetSeconds;
+
+        if (converged || outOfTime || lastPass) {
+            writer.save(image.snapshot(), g_job->outputStem(), false);
+
+            if (g_job->denoise()) {
+                saveDenoised(accumulator, *m_aovBuffer, cropWindow, i + 1, false, writer);
+            }
+
+            // A budgeted render stops short; leave it resumable from here.
+            // The final state is kept too, it's what distributed workers
+            // hand back to pathed_merge.
+            Trace::Scope checkpointScope("saveAccumulator");
+            if (!accumulator.saveCheckpoint(g_job->checkpointPath(), checkpointInfo)) {
+                Logger::line("failed to write " + g_job->checkpointPath());
+            }
+        }
 
         std::ostringstream sampleStream;
         sampleStream << "sample: " << i + 1 << "/" << primarySamples
                      << std::fixed << std::setprecision(1)
-                     << " (" << elapsedSeconds << "s elapsed)";
+                     << " (" << elapsedSeconds << "s elapsed, "
+                     << passCounters.totalRays() / elapsedSeconds / 1e6 << " Mrays/s)";
+        if (adaptive) {
+            sampleStream << " active: " << activePixels << "/" << width * height;
+        }
 
         Logger::line(sampleStream.str());
 
+        nlohmann::json stats = renderCounters.toJSON(sampleSeconds);
+        stats["passes"] = i + 1;
+        g_job->writeStats(stats);
+        Trace::write(g_job->outputDirectory() + "trace.json");
+
+        if (converged) {
+            const uint64_t uniformSamples = (uint64_t)width * height * (i + 1);
+
+            std::ostringstream convergedStream;
+            convergedStream << "converged: " << accumulator.totalSamples()
+                            << " samples (" << uniformSamples << " uniform)";
+            Logger::line(convergedStream.str());
+            return;
+        }
+
+        if (outOfTime) {
+            std::ostringstream budgetStream;
+            budgetStream << "time budget: stopping after " << i + 1 << " samples"
+                         << std::fixed << std::setprecision(1)
+                         << " (" << renderSeconds << "s of " << timeBudgetSeconds << "s)";
+            Logger::line(budgetStream.str());
+            return;
+        }
+
         if (*quit) { return; }
     }
 }
+
+void Integrator::captureSamples(int pixelIndex)
+{
+    std::lock_guard<std::mutex> guard(m_captureLock);
+    m_capturedPixels.insert(pixelIndex);
+}
+
+SampleLookup Integrator::emptySampleLookup()
+{
+    std::lock_guard<std::mutex> guard(m_captureLock);
+
+    SampleLookup sampleLookup;
+    for (int pixelIndex : m_capturedPixels) {
+        sampleLookup.emplace(pixelIndex, Sample(true));
+    }
+    return sampleLookup;
+}
@@ -2,8 +2,10 @@
 
 #include "albedo_integrator.h"
 #include "basic_volume_integrator.h"
+#include "blue_noise_sampler.h"
 #include "data_parallel_integrator.h"
 #include "depositer.h"
+#include "halton_sampler.h"
 #include "light_tracer.h"
 #include "ml_integrator.h"
 #include "nearest_photon.h"
@@ -12,11 +14,19 @@
 #include "pdf_integrator.h"
 #include "render_backsides.h"
 #include "self_integrator.h"
+#include "sobol_sampler.h"
 #include "volume_path_tracer.h"
+#include "wavefront_integrator.h"
 
+#include "tinyexr.h"
+
+#include <algorithm>
+#include <assert.h>
 #include <errno.h>
 #include <iomanip>
+#include <random>
 #include <sstream>
+#include <stdexcept>
 #include <stdlib.h>
 #include <sys/stat.h>
 
@@ -27,39 +37,132 @@ Job::Job(std::ifstream &jobFile)
       m_bounceController(
           m_json["startBounce"].get<int>(),
           m_json["lastBounce"].get<int>()
-      )
-{}
+      ),
+      m_resume(false),
+      m_checkpointName("accumulator.ckpt"),
+      m_outputStem("auto"),
+      m_tileRangeBegin(0),
+      m_tileRangeEnd(-1)
+{
+    // Without a seed every run differs; record the one we drew in report.json
+    // so the render can be reproduced
+    if (m_json["seed"].is_number_unsigned()) {
+        m_seed = m_json["seed"].get<uint64_t>();
+    } else {
+        std::random_device device;
+        m_seed = device();
+        m_json["seed"] = m_seed;
+    }
+}
 
 void Job::init()
 {
     std::string directory = outputDirectory();
 
+    // Resuming expects the directories a previous run left behind
     int result = mkdir(directory.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
     if (result == -1) {
-        if (errno == EEXIST) {
+        const bool exists = errno == EEXIST;
+        if (exists) {
             std::cout << "Output directory already exists: " << directory << std::endl;
         } else {
             std::cout << "Failed to create: " << directory << std::endl;
         }
-        if (!force()) {
+        if (!force() && !(m_resume && exists)) {
             exit(1);
         }
     }
 
     result = mkdir(visualizationDirectory().c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
     if (result == -1) {
-        std::cout << "Failed to create: " << visualizationDirectory() << std::endl;
-        if (!force()) {
-            exit(1);
+        const bool exists = errno == EEXIST;
+        if (!(m_resume && exists)) {
+            std::cout << "Failed to create: " << visualizationDirectory() << std::endl;
+            if (!force()) {
+                exit(1);
+            }
         }
     }
 
+    writeReport();
+}
+
+// FNV-1a
+static uint64_t hashBytes(uint64_t hash, const std::string &bytes)
+{
+    for (unsigned char byte : bytes) {
+        hash ^= byte;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+uint64_t Job::checkpointHash() const
+{
+    json settings = m_json;
+    for (const char *key : { "seed", "spp", "time_budget_seconds", "force", "showUI", "crop_composite" }) {
+        settings.erase(key);
+    }
+
+    std::ifstream sceneFile(scene(), std::ios::binary);
+    std::ostringstream sceneContents;
+    sceneContents << sceneFile.rdbuf();
+
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hash = hashBytes(hash, settings.dump());
+    hash = hashBytes(hash, sceneContents.str());
+    return hash;
+}
+
+void Job::setTileRange(int begin, int end)
+{
+    assert(0 <= begin && begin <= end);
+
+    m_tileRangeBegin = begin;
+    m_tileRangeEnd = end;
+}
+
+void Job::restoreSeed(uint64_t seed)
+{
+    m_seed = seed;
+    m_json["seed"] = m_seed;
+    writeReport();
+}
+
+void Job::writeStats(const nlohmann::json &stats)
+{
+    m_stats = stats;
+    writeReport();
+}
+
+void Job::writeReport() const
+{
     std::ostringstream outputFilenameStream;
-    outputFilenameStream << directory << "/" << "report.json";
+    outputFilenameStream << outputDirectory() << "/" << "report.json";
     std::string outputFilename = outputFilenameStream.str();
 
+    nlohmann::json report = m_json;
+    if (!m_stats.is_null()) {
+        report["stats"] = m_stats;
+    }
+
     std::ofstream outputStream(outputFilename);
-    outputStream << std::setw(4) << m_json << std::endl;
+    outputStream << std::setw(4) << report << std::endl;
+}
+
+RussianRoulette Job::russianRoulette() const
+{
+    if (!m_json.count("russian_roulette")) { return RussianRoulette(); }
+
+    const json &settings = m_json["russian_roulette"];
+    const json weightWindow = settings.value("weight_window", json::array({ 0.1f, 0.f }));
+
+    return RussianRoulette(
+        settings.value("start_bounce", 3),
+        weightWindow[0].get<float>(),
+        weightWindow[1].get<float>(),
+        settings.value("max_split", 1)
+    );
 }
 
 std::shared_ptr<Integrator> Job::integrator() const
@@ -92,6 +195,84 @@ std::shared_ptr<Integrator> Job::integrator() const
         return std::make_shared<AlbedoIntegrator>();
     } else if (integrator == "OptimalMISIntegrator") {
         return std::make_shared<OptimalMISIntegrator>();
+    } else if (integrator == "WavefrontIntegrator") {
+        return std::make_shared<WavefrontIntegrator>(m_bounceController);
+    }
+    throw std::runtime_error("Unknown integrator: " + integrator);
+}
+
+std::vector<int> Job::debugPixels() const
+{
+    std::vector<int> pixelIndices;
+    if (m_json.count("debug_pixels") == 0) { return pixelIndices; }
+
+    const int width = this->width();
+    const int height = this->height();
+    for (const auto &pixel : m_json["debug_pixels"]) {
+        const int x = pixel[0].get<int>();
+        const int y = pixel[1].get<int>();
+        if (x < 0 || x >= width || y < 0 || y >= height) {
+            std::cout << "Ignoring debug pixel outside the image: " << x << ", " << y << std::endl;
+            continue;
+        }
+
+        // Pixel rows count up from the bottom of the image
+        pixelIndices.push_back((height - y - 1) * width + x);
+    }
+    return pixelIndices;
+}
+
+int Job::exrCompression() const
+{
+    const std::string compression = m_json.value("exr_compression", "none");
+
+    if (compression == "none") { return TINYEXR_COMPRESSIONTYPE_NONE; }
+    if (compression == "rle") { return TINYEXR_COMPRESSIONTYPE_RLE; }
+    if (compression == "zips") { return TINYEXR_COMPRESSIONTYPE_ZIPS; }
+    if (compression == "zip") { return TINYEXR_COMPRESSIONTYPE_ZIP; }
+    if (compression == "piz") { return TINYEXR_COMPRESSIONTYPE_PIZ; }
+
+    std::cout << "Unknown EXR compression, writing uncompressed: " << compression << std::endl;
+    return TINYEXR_COMPRESSIONTYPE_NONE;
+}
+
+Tile Job::cropWindow() const
+{
+    const int width = this->width();
+    const int height = this->height();
+
+    Tile window = { 0, height, 0, width };
+    if (!hasCrop()) { return window; }
+
+    const json &crop = m_json["crop"];
+    const int x = crop[0].get<int>();
+    const int y = crop[1].get<int>();
+
+    // Flip the top-down crop into bottom-up pixel rows
+    window.startRow = std::max(0, height - (y + crop[3].get<int>()));
+    window.endRow = std::min(height, height - y);
+    window.startCol = std::max(0, x);
+    window.endCol = std::min(width, x + crop[2].get<int>());
+
+    if (window.startRow >= window.endRow || window.startCol >= window.endCol) {
+        throw std::runtime_error("Crop window is empty or outside the image");
+    }
+
+    return window;
+}
+
+std::unique_ptr<Sampler> Job::sampler() const
+{
+    const std::string sampler = m_json.value("sampler", "independent");
+
+    if (sampler == "independent") {
+        return std::make_unique<Sampler>(m_seed);
+    } else if (sampler == "sobol") {
+        return std::make_unique<SobolSampler>(m_seed);
+    } else if (sampler == "halton") {
+        return std::make_unique<HaltonSampler>(m_seed);
+    } else if (sampler == "blue_noise") {
+        return std::make_unique<BlueNoiseSampler>(m_seed, width());
     }
-    throw "Unimplemented";
+    throw std::runtime_error("Unknown sampler: " + sampler);
 }
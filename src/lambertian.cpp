@@ -29,7 +29,7 @@ Color Lambertian::f(
         return Color(0.f);
     }
 
-    const Vector3 wi = intersection.worldToTangent.apply(wiWorld).normalized();
+    const Vector3 wi = intersection.frame().toLocal(wiWorld).normalized();
     *pdf = CosineHemispherePdf(wi);
 
     if (m_albedo) {
@@ -45,7 +45,7 @@ BSDFSample Lambertian::sample(
 ) const
 {
     Vector3 localSample = CosineSampleHemisphere(random);
-    Vector3 worldSample = intersection.tangentToWorld.apply(localSample);
+    Vector3 worldSample = intersection.frame().toWorld(localSample);
 
     BSDFSample sample = {
         .wiWorld = worldSample,
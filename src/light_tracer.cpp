@@ -24,7 +24,7 @@ void LightTracer::splat(
     const Color &radiance,
     const Intersection &intersection,
     const Scene &scene,
-    std::vector<float> &radianceLookup
+    Accumulator &accumulator
 ) const {
     const Point3 &source = intersection.point;
     const Camera &camera = *scene.getCamera();
@@ -43,7 +43,7 @@ void LightTracer::splat(
     camera.calculatePixel(source, pixel);
     if (!pixel) { return; }
 
-    const size_t index = 3 * (pixel->y * camera.getResolution().x + pixel->x);
+    const int pixelIndex = pixel->y * camera.getResolution().x + pixel->x;
 
     const Color brdf = intersection.material->f(intersection, wi);
     const float cosTheta = std::max(0.f, intersection.normal.dot(wi));
@@ -51,14 +51,12 @@ void LightTracer::splat(
     const Color splattedRadiance = radiance * brdf * cosTheta / (distance * distance);
 
     lock.lock();
-    radianceLookup[index + 0] += splattedRadiance.r();
-    radianceLookup[index + 1] += splattedRadiance.g();
-    radianceLookup[index + 2] += splattedRadiance.b();
+    accumulator.splat(pixelIndex, splattedRadiance);
     lock.unlock();
 }
 
 void LightTracer::measure(
-    std::vector<float> &radianceLookup,
+    Accumulator &accumulator,
     const Scene &scene,
     RandomGenerator &random
 ) const {
@@ -86,7 +84,7 @@ void LightTracer::measure(
         Intersection intersection = scene.testIntersect(lightRay);
         if (!intersection.hit) { break; }
 
-        splat(throughput, intersection, scene, radianceLookup);
+        splat(throughput, intersection, scene, accumulator);
 
         const Vector3 hemisphereSample = UniformSampleHemisphere(random);
         const Transform hemisphereToWorld = normalToWorldSpace(intersection.normal);
@@ -104,20 +102,32 @@ void LightTracer::measure(
 }
 
 void LightTracer::sampleImage(
-    std::vector<float> &radianceLookup,
-    std::vector<Sample> &sampleLookup,
+    Accumulator &accumulator,
+    SampleLookup &sampleLookup,
     Scene &scene,
-    RandomGenerator &random
+    RandomGenerator &random,
+    int sampleIndex
 ) {
     const int width = g_job->width();
     const int height = g_job->height();
 
-    #pragma omp parallel for
-    for (int i = 0; i < width * height; i++) {
-        measure(
-            radianceLookup,
-            scene,
-            random
-        );
+    const uint64_t seed = g_job->seed() + sampleIndex;
+
+    #pragma omp parallel
+    {
+        RandomGenerator pathRandom(seed, 0);
+
+        #pragma omp for
+        for (int i = 0; i < width * height; i++) {
+            pathRandom.reseed(seed, i);
+
+            measure(
+                accumulator,
+                scene,
+                pathRandom
+            );
+        }
     }
+
+    accumulator.addSplatPass();
 }
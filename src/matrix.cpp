@@ -3,8 +3,9 @@
 #include "vector.h"
 
 #include <math.h>
+#include <stdio.h>
 
-void matrix::debugMatrix(GLfloat (&matrix)[4][4])
+void matrix::debugMatrix(float (&matrix)[4][4])
 {
     for (int i = 0; i < 4; i++) {
         for (int j = 0; j < 4; j++) {
@@ -14,7 +15,7 @@ void matrix::debugMatrix(GLfloat (&matrix)[4][4])
     }
 }
 
-void matrix::debugMatrix(GLfloat (&matrix)[4][1])
+void matrix::debugMatrix(float (&matrix)[4][1])
 {
     for (int i = 0; i < 4; i++) {
         for (int j = 0; j < 1; j++) {
@@ -24,7 +25,7 @@ void matrix::debugMatrix(GLfloat (&matrix)[4][1])
     }
 }
 
-void matrix::copyMatrix(GLfloat (&source)[4][4], GLfloat (&target)[4][4])
+void matrix::copyMatrix(float (&source)[4][4], float (&target)[4][4])
 {
     for (int i = 0; i < 4; i++) {
         for (int j = 0; j < 4; j++) {
@@ -33,35 +34,35 @@ void matrix::copyMatrix(GLfloat (&source)[4][4], GLfloat (&target)[4][4])
     }
 }
 
-void matrix::scale(GLfloat (&result)[4][4], GLfloat x, GLfloat y, GLfloat z)
+void matrix::scale(float (&result)[4][4], float x, float y, float z)
 {
-    GLfloat scaled[4][4];
+    float scaled[4][4];
     makeIdentity(scaled);
 
     scaled[0][0] = x;
     scaled[1][1] = y;
     scaled[2][2] = z;
 
-    GLfloat original[4][4];
+    float original[4][4];
     copyMatrix(result, original);
     multiply(result, scaled, original);
 }
 
-void matrix::translate(GLfloat (&result)[4][4], GLfloat x, GLfloat y, GLfloat z)
+void matrix::translate(float (&result)[4][4], float x, float y, float z)
 {
-    GLfloat translation[4][4];
+    float translation[4][4];
     makeIdentity(translation);
 
     translation[0][3] = x;
     translation[1][3] = y;
     translation[2][3] = z;
 
-    GLfloat original[4][4];
+    float original[4][4];
     copyMatrix(result, original);
     multiply(result, translation, original);
 }
 
-void matrix::multiply(GLfloat (&result)[4][4], GLfloat (&A)[4][4], GLfloat (&B)[4][4])
+void matrix::multiply(float (&result)[4][4], float (&A)[4][4], float (&B)[4][4])
 {
     for (int row = 0; row < 4; row++) {
         for (int col = 0; col < 4; col++) {
@@ -74,7 +75,7 @@ void matrix::multiply(GLfloat (&result)[4][4], GLfloat (&A)[4][4], GLfloat (&B)[
     }
 }
 
-void matrix::multiply(GLfloat (&result)[4][1], GLfloat (&A)[4][4], GLfloat (&x)[4][1])
+void matrix::multiply(float (&result)[4][1], float (&A)[4][4], float (&x)[4][1])
 {
     for (int row = 0; row < 4; row++) {
         for (int col = 0; col < 1; col++) {
@@ -87,9 +88,9 @@ void matrix::multiply(GLfloat (&result)[4][1], GLfloat (&A)[4][4], GLfloat (&x)[
     }
 }
 
-void matrix::rotateX(GLfloat (&result)[4][4], GLfloat theta)
+void matrix::rotateX(float (&result)[4][4], float theta)
 {
-    GLfloat rotation[4][4];
+    float rotation[4][4];
     makeIdentity(rotation);
 
     rotation[1][1] = cosf(theta);
@@ -97,14 +98,14 @@ void matrix::rotateX(GLfloat (&result)[4][4], GLfloat theta)
     rotation[2][1] = sinf(theta);
     rotation[2][2] = cosf(theta);
 
-    GLfloat original[4][4];
+    float original[4][4];
     copyMatrix(result, original);
     multiply(result, rotation, original);
 }
 
-void matrix::rotateY(GLfloat (&result)[4][4], GLfloat theta)
+void matrix::rotateY(float (&result)[4][4], float theta)
 {
-    GLfloat rotation[4][4];
+    float rotation[4][4];
     makeIdentity(rotation);
 
     rotation[0][0] = cosf(theta);
@@ -112,14 +113,14 @@ void matrix::rotateY(GLfloat (&result)[4][4], GLfloat theta)
     rotation[2][0] = -sinf(theta);
     rotation[2][2] = cosf(theta);
 
-    GLfloat original[4][4];
+    float original[4][4];
     copyMatrix(result, original);
     multiply(result, rotation, original);
 }
 
-void matrix::rotateZ(GLfloat (&result)[4][4], GLfloat theta)
+void matrix::rotateZ(float (&result)[4][4], float theta)
 {
-    GLfloat rotation[4][4];
+    float rotation[4][4];
     makeIdentity(rotation);
 
     rotation[0][0] = cosf(theta);
@@ -127,12 +128,12 @@ void matrix::rotateZ(GLfloat (&result)[4][4], GLfloat theta)
     rotation[1][0] = sinf(theta);
     rotation[1][1] = cosf(theta);
 
-    GLfloat original[4][4];
+    float original[4][4];
     copyMatrix(result, original);
     multiply(result, rotation, original);
 }
 
-void matrix::makeIdentity(GLfloat (&m)[4][4])
+void matrix::makeIdentity(float (&m)[4][4])
 {
     for (int row = 0; row < 4; row++) {
         for (int col = 0; col < 4; col++) {
@@ -142,7 +143,7 @@ void matrix::makeIdentity(GLfloat (&m)[4][4])
 }
 
 void matrix::buildView(
-    GLfloat (&view)[4][4],
+    float (&view)[4][4],
     float originX, float originY, float originZ,
     float targetX, float targetY, float targetZ
 )
@@ -157,21 +158,21 @@ void matrix::buildView(
     Vector3 tangent = up.cross(lookAt).normalized();
     Vector3 bitangent = lookAt.cross(tangent).normalized();
 
-    GLfloat basis[4][4] = {
+    float basis[4][4] = {
         tangent.x(), tangent.y(), tangent.z(), 0.f,
         bitangent.x(), bitangent.y(), bitangent.z(), 0.f,
         -lookAt.x(), -lookAt.y(), -lookAt.z(), 0.f,
         0.f, 0.f, 0.f, 1.f
     };
 
-    GLfloat translation[4][4];
+    float translation[4][4];
     makeIdentity(translation);
     translate(translation, -originX, -originY, -originZ);
     multiply(view, basis, translation);
 }
 
 void matrix::buildOrthographicProjection(
-    GLfloat (&projection)[4][4],
+    float (&projection)[4][4],
     float left, float right, float bottom, float top,
     float zFar, float zNear
 ) {
@@ -188,7 +189,7 @@ void matrix::buildOrthographicProjection(
 }
 
 void matrix::buildPerspectiveProjection(
-    GLfloat (&projection)[4][4],
+    float (&projection)[4][4],
     float fovY, float aspectRatio, float zFar, float zNear
 ) {
     makeIdentity(projection);
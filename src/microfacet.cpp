@@ -15,8 +15,8 @@ Color Microfacet::f(
     float *pdf
 ) const
 {
-    const Vector3 wo = intersection.worldToTangent.apply(intersection.woWorld).normalized();
-    const Vector3 wi = intersection.worldToTangent.apply(wiWorld).normalized();
+    const Vector3 wo = intersection.frame().toLocal(intersection.woWorld).normalized();
+    const Vector3 wi = intersection.frame().toLocal(wiWorld).normalized();
 
     if (intersection.woWorld.dot(intersection.shadingNormal) < 0.f) {
         *pdf = 0.f;
@@ -61,11 +61,11 @@ BSDFSample Microfacet::sample(
     RandomGenerator &random
 ) const
 {
-    const Vector3 wo = intersection.worldToTangent.apply(intersection.woWorld);
+    const Vector3 wo = intersection.frame().toLocal(intersection.woWorld);
     const Vector3 wh = m_distributionPtr->sampleWh(wo, random);
     const Vector3 wi = wo.reflect(wh);
 
-    const Vector3 wiWorld = intersection.tangentToWorld.apply(wi);
+    const Vector3 wiWorld = intersection.frame().toWorld(wi);
 
     BSDFSample sample = {
         .wiWorld = wiWorld,
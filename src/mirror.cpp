@@ -23,11 +23,11 @@ BSDFSample Mirror::sample(
     RandomGenerator &random
 ) const
 {
-    Vector3 localWo = intersection.worldToTangent.apply(intersection.woWorld);
+    Vector3 localWo = intersection.frame().toLocal(intersection.woWorld);
     Vector3 localWi = localWo.reflect(Vector3(0.f, 1.f, 0.f));
 
     BSDFSample sample = {
-        .wiWorld = intersection.tangentToWorld.apply(localWi),
+        .wiWorld = intersection.frame().toWorld(localWi),
         .pdf = 1.f,
         .throughput = Color(std::max(0.f, 1.f / localWi.y())),
         .material = this
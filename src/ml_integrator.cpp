@@ -122,7 +122,7 @@ void MLIntegrator::renderPDF(
             float z = sinf(theta) * sinf(phi);
 
             Vector3 wiHemisphere(x, y, z);
-            Vector3 wiWorld = intersection.tangentToWorld.apply(wiHemisphere);
+            Vector3 wiWorld = intersection.frame().toWorld(wiHemisphere);
 
             Ray ray = Ray(intersection.point, wiWorld);
             const Intersection fisheyeIntersection = scene.testIntersect(ray);
@@ -185,8 +185,8 @@ Vector3 MLIntegrator::nextBounce(const Intersection &intersection, const Scene &
         g_job->thetaSteps()
     );
 
-    std::vector<float> photonBundle = photonPDF.asVector(intersection.worldToTangent);
-    //photonPDF.save("photons", intersection.worldToTangent);
+    std::vector<float> photonBundle = photonPDF.asVector(intersection.frame().toLocalTransform());
+    //photonPDF.save("photons", intersection.frame().toLocalTransform());
 
     float phi, theta;
     m_MLPDF.sample(&phi, &theta, pdf, photonBundle);
@@ -196,7 +196,7 @@ Vector3 MLIntegrator::nextBounce(const Intersection &intersection, const Scene &
     Vector3 hemisphereSample = sphericalToCartesian(phi, theta);
     // hemisphereSample.debug();
 
-    // Vector3 bounceDirection = intersection.worldToTangent.transposed().apply(hemisphereSample);
+    // Vector3 bounceDirection = intersection.frame().toWorld(hemisphereSample);
 
     // if (imageIndex == 0) {
     //     const int width = g_job->width();
@@ -297,7 +297,7 @@ Color MLIntegrator::L(
 
     for (int bounce = 2; !m_bounceController.checkDone(bounce); bounce++) {
         float pdf;
-        Vector3 bounceDirection = intersection.tangentToWorld.apply(
+        Vector3 bounceDirection = intersection.frame().toWorld(
             nextBounce(intersection, scene, &pdf)
         );
 
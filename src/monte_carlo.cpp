@@ -7,9 +7,10 @@
 
 Vector3 UniformSampleHemisphere(RandomGenerator &random)
 {
-    float z = random.next();
+    const std::array<float, 2> xi = random.next2D();
+    float z = xi[0];
     float r = sqrtf(fmaxf(0.f, 1.f - z*z));
-    float phi = 2 * M_PI * random.next();
+    float phi = 2 * M_PI * xi[1];
     float x = r * cosf(phi);
     float y = r * sinf(phi);
 
@@ -23,9 +24,10 @@ float UniformHemispherePdf(const Vector3 &v)
 
 Vector3 CosineSampleHemisphere(RandomGenerator &random)
 {
-    const float xi1 = random.next();
+    const std::array<float, 2> xi = random.next2D();
+    const float xi1 = xi[0];
     const float r = sqrtf(xi1);
-    const float phi = 2 * M_PI * random.next();
+    const float phi = 2 * M_PI * xi[1];
 
     const float x = r * cosf(phi);
     const float z = r * sinf(phi);
@@ -42,9 +44,10 @@ float CosineHemispherePdf(const Vector3 &v)
 
 Vector3 UniformSampleSphere(RandomGenerator &random)
 {
-    float z = random.next() * 2.f - 1;
+    const std::array<float, 2> xi = random.next2D();
+    float z = xi[0] * 2.f - 1;
     float r = sqrtf(fmaxf(0.f, 1.f - z*z));
-    float phi = 2 * M_PI * random.next();
+    float phi = 2 * M_PI * xi[1];
     float x = r * cosf(phi);
     float y = r * sinf(phi);
 
@@ -29,7 +29,7 @@ void OptimalMISIntegrator::preprocessPixel(
     for (int i = 0; i < iterationCount; i++) {
         Sample sample;
 
-        const Ray ray = scene.getCamera()->generateRay(row, col);
+        const Ray ray = scene.getCamera()->generateRay(row, col, random);
 
         const Intersection intersection = scene.testIntersect(ray);
         if (!intersection.hit) { return; }
@@ -33,8 +33,8 @@ Color OrenNayar::f(
         return Color(0.f);
     }
 
-    const Vector3 localWo = intersection.worldToTangent.apply(intersection.woWorld).normalized();
-    const Vector3 localWi = intersection.worldToTangent.apply(wiWorld).normalized();
+    const Vector3 localWo = intersection.frame().toLocal(intersection.woWorld).normalized();
+    const Vector3 localWi = intersection.frame().toLocal(wiWorld).normalized();
 
     if (localWo.y() < 0.f) {
         *pdf = 1.f;
@@ -72,7 +72,7 @@ BSDFSample OrenNayar::sample(
 ) const
 {
     Vector3 localSample = CosineSampleHemisphere(random);
-    Vector3 worldSample = intersection.tangentToWorld.apply(localSample);
+    Vector3 worldSample = intersection.frame().toWorld(localSample);
 
     BSDFSample sample = {
         .wiWorld = worldSample,
@@ -15,6 +15,13 @@
 
 #include <fstream>
 #include <iostream>
+#include <vector>
+
+PathTracer::PathTracer(BounceController bounceController)
+    : m_bounceController(bounceController),
+      m_lightSamples(g_job->lightSamples()),
+      m_russianRoulette(g_job->russianRoulette())
+{}
 
 Color PathTracer::L(
     const Intersection &intersection,
@@ -23,28 +30,83 @@ Color PathTracer::L(
     int pixelIndex,
     Sample &sample
 ) const {
-    // if (pixelIndex != (600 - 152) * 800 + 225) { return Color(0.f); }
+    // Direct callers (PDF renders, per-direction estimates) come through here
+    // once per ray, so keep the queue's buffers around between calls
+    static thread_local ShadowQueue shadowQueue;
+    static thread_local std::vector<Color> shadowResults(1, Color(0.f));
+
+    shadowResults[0] = Color(0.f);
+
+    const Color result = queuedL(intersection, scene, random, pixelIndex, sample, shadowQueue);
+    shadowQueue.resolve(scene, shadowResults);
+
+    return result + shadowResults[0];
+}
 
-    sample.eyePoints.push_back(intersection.point);
+// Unoccluded light samples are left in shadowQueue, already weighted by the
+// path throughput; the returned radiance is everything else
+Color PathTracer::queuedL(
+    const Intersection &intersection,
+    const Scene &scene,
+    RandomGenerator &random,
+    int pixelIndex,
+    Sample &sample,
+    ShadowQueue &shadowQueue
+) const {
+    // if (pixelIndex != (600 - 152) * 800 + 225) { return Color(0.f); }
 
-    BSDFSample bsdfSample = intersection.material->sample(intersection, random);
+    sample.recordEyePoint(intersection.point);
 
     Color result(0.f);
-    if (m_bounceController.checkCounts(1)) {
-        result = direct(intersection, bsdfSample, scene, random, sample);
-        sample.contributions.push_back({result, 1.f});
+
+    // Split copies wait here until the path that spawned them is finished
+    std::vector<PathVertex> pending = { { intersection, Color(1.f), 1, 1.f } };
+    while (!pending.empty()) {
+        const PathVertex vertex = pending.back();
+        pending.pop_back();
+
+        result += extendPath(vertex, scene, random, sample, shadowQueue, pending);
     }
 
-    Color modulation = Color(1.f);
-    Intersection lastIntersection = intersection;
+    return result;
+}
+
+Color PathTracer::extendPath(
+    const PathVertex &vertex,
+    const Scene &scene,
+    RandomGenerator &random,
+    Sample &sample,
+    ShadowQueue &shadowQueue,
+    std::vector<PathVertex> &pending
+) const {
+    Color modulation = vertex.modulation;
+    Intersection lastIntersection = vertex.intersection;
+
+    BSDFSample bsdfSample = lastIntersection.material->sample(lastIntersection, random);
+
+    Color result(0.f);
+    if (m_bounceController.checkCounts(vertex.bounce)) {
+        Color Ld = direct(
+            lastIntersection,
+            bsdfSample,
+            modulation,
+            scene,
+            random,
+            sample,
+            shadowQueue
+        );
+        result += Ld * modulation;
+
+        sample.recordContribution({result, vertex.invPDF});
+    }
 
-    for (int bounce = 2; !m_bounceController.checkDone(bounce); bounce++) {
+    for (int bounce = vertex.bounce + 1; !m_bounceController.checkDone(bounce); bounce++) {
         Ray bounceRay(lastIntersection.point, bsdfSample.wiWorld);
 
         Intersection bounceIntersection = scene.testIntersect(bounceRay);
         if (!bounceIntersection.hit) { break; }
 
-        sample.eyePoints.push_back(bounceIntersection.point);
+        sample.recordEyePoint(bounceIntersection.point);
 
         const float invPDF = 1.f / bsdfSample.pdf;
         const float cosTheta = WorldFrame::absCosTheta(lastIntersection.shadingNormal, bsdfSample.wiWorld);
@@ -57,6 +119,19 @@ Color PathTracer::L(
             break;
         }
 
+        // Paths are left alone until they reach bounces that count, so
+        // startBounce experiments see the same paths with roulette on
+        if (bounce >= m_bounceController.startBounce()) {
+            float weight;
+            const int copies = m_russianRoulette.evaluate(bounce, modulation, random, &weight);
+            if (copies == 0) { break; }
+
+            modulation *= weight;
+            for (int copy = 1; copy < copies; copy++) {
+                pending.push_back({ bounceIntersection, modulation, bounce, invPDF });
+            }
+        }
+
         bsdfSample = bounceIntersection.material->sample(
             bounceIntersection, random
         );
@@ -66,10 +141,18 @@ Color PathTracer::L(
         if (m_bounceController.checkCounts(bounce)) {
             const Color previous = result;
 
-            Color Ld = direct(bounceIntersection, bsdfSample, scene, random, sample);
+            Color Ld = direct(
+                bounceIntersection,
+                bsdfSample,
+                modulation,
+                scene,
+                random,
+                sample,
+                shadowQueue
+            );
             result += Ld * modulation;
 
-            sample.contributions.push_back({result - previous, invPDF});
+            sample.recordContribution({result - previous, invPDF});
         }
     }
 
@@ -79,9 +162,11 @@ Color PathTracer::L(
 Color PathTracer::direct(
     const Intersection &intersection,
     const BSDFSample &bsdfSample,
+    const Color &modulation,
     const Scene &scene,
     RandomGenerator &random,
-    Sample &sample
+    Sample &sample,
+    ShadowQueue &shadowQueue
 ) const {
     Color emit = intersection.material->emit();
     if (!emit.isBlack()) {
@@ -94,9 +179,11 @@ Color PathTracer::direct(
     result += directSampleLights(
         intersection,
         bsdfSample,
+        modulation,
         scene,
         random,
-        sample
+        sample,
+        shadowQueue
     );
 
     result += directSampleBSDF(
@@ -110,58 +197,73 @@ Color PathTracer::direct(
     return result;
 }
 
+// Shadow rays normally go to shadowQueue, weighted by modulation, and
+// contribute nothing here. Captured debug samples trace them on the spot so
+// that each shadow test can be recorded with its outcome.
 Color PathTracer::directSampleLights(
     const Intersection &intersection,
     const BSDFSample &bsdfSample,
+    const Color &modulation,
     const Scene &scene,
     RandomGenerator &random,
-    Sample &sample
+    Sample &sample,
+    ShadowQueue &shadowQueue
 ) const {
     if (bsdfSample.material->isDelta()) { return 0.f; }
 
-    const LightSample lightSample = scene.sampleDirectLights(intersection.point, random);
+    Color result(0.f);
 
-    const Vector3 lightDirection = (lightSample.point - intersection.point).toVector();
-    const Vector3 wiWorld = lightDirection.normalized();
+    for (int i = 0; i < m_lightSamples; i++) {
+        const LightSample lightSample = scene.sampleDirectLights(intersection.point, random);
 
-    if (lightSample.normal.dot(wiWorld) >= 0.f) {
-        // Sample hit back of light
-        sample.shadowTests.push_back({
-            intersection.point,
-            lightSample.point,
-            true
-        });
+        const Vector3 lightDirection = (lightSample.point - intersection.point).toVector();
+        const Vector3 wiWorld = lightDirection.normalized();
 
-        return Color(0.f);
-    }
+        if (lightSample.normal.dot(wiWorld) >= 0.f) {
+            // Sample hit back of light
+            sample.recordShadowTest({
+                intersection.point,
+                lightSample.point,
+                true
+            });
 
-    const Ray shadowRay = Ray(intersection.point, wiWorld);
-    const float lightDistance = lightDirection.length();
-    const bool occluded = scene.testOcclusion(shadowRay, lightDistance);
+            continue;
+        }
 
-    sample.shadowTests.push_back({
-        intersection.point,
-        lightSample.point,
-        occluded
-    });
+        const float pdf = lightSample.solidAnglePDF(intersection.point);
+        const float brdfPDF = bsdfSample.material->pdf(intersection, wiWorld);
+        const float lightWeight = MIS::balanceWeight(m_lightSamples, 1, pdf, brdfPDF);
 
-    if (occluded) {
-        return Color(0.f);
-    }
+        const Vector3 lightWo = -lightDirection.normalized();
+
+        const Color lightContribution = lightSample.light->emit(lightWo)
+            * lightWeight
+            * intersection.material->f(intersection, wiWorld)
+            * WorldFrame::absCosTheta(intersection.shadingNormal, wiWorld)
+            / (pdf * m_lightSamples);
+
+        const Ray shadowRay = Ray(intersection.point, wiWorld);
+        const float lightDistance = lightDirection.length();
+
+        if (!sample.recording) {
+            shadowQueue.push(shadowRay, lightDistance, lightContribution * modulation);
+            continue;
+        }
 
-    const float pdf = lightSample.solidAnglePDF(intersection.point);
-    const float brdfPDF = bsdfSample.material->pdf(intersection, wiWorld);
-    const float lightWeight = MIS::balanceWeight(1, 1, pdf, brdfPDF);
+        const bool occluded = scene.testOcclusion(shadowRay, lightDistance);
 
-    const Vector3 lightWo = -lightDirection.normalized();
+        sample.recordShadowTest({
+            intersection.point,
+            lightSample.point,
+            occluded
+        });
 
-    const Color lightContribution = lightSample.light->emit(lightWo)
-        * lightWeight
-        * intersection.material->f(intersection, wiWorld)
-        * WorldFrame::absCosTheta(intersection.shadingNormal, wiWorld)
-        / pdf;
+        if (!occluded) {
+            result += lightContribution;
+        }
+    }
 
-    return lightContribution;
+    return result;
 }
 
 Color PathTracer::directSampleBSDF(
@@ -185,7 +287,7 @@ Color PathTracer::directSampleBSDF(
         );
         const float brdfWeight = bsdfSample.material->isDelta()
             ? 1.f
-            : MIS::balanceWeight(1, 1, bsdfSample.pdf, lightPDF);
+            : MIS::balanceWeight(1, m_lightSamples, bsdfSample.pdf, lightPDF);
 
         const Color brdfContribution = bounceIntersection.material->emit()
             * brdfWeight
@@ -200,7 +302,7 @@ Color PathTracer::directSampleBSDF(
             const float lightPDF = scene.environmentPDF(bsdfSample.wiWorld, Measure::SolidAngle);
             const float brdfWeight = bsdfSample.material->isDelta()
                 ? 1.f
-                : MIS::balanceWeight(1, 1, bsdfSample.pdf, lightPDF);
+                : MIS::balanceWeight(1, m_lightSamples, bsdfSample.pdf, lightPDF);
 
             const Color brdfContribution = environmentL
                 * brdfWeight
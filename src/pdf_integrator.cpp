@@ -16,7 +16,6 @@
 #include <ctime>
 #include <iomanip>
 #include <iostream>
-#include <mutex>
 #include <sstream>
 
 static std::string zeroPad(int num, int fillCount)
@@ -153,7 +152,7 @@ Intersection PDFIntegrator::generateIntersection(
         int row = (int)(y * height);
         int col = (int)(x * width);
 
-        Ray ray = scene.getCamera()->generateRay(row, col);
+        Ray ray = scene.getCamera()->generateRay(row, col, random);
         Intersection intersection = scene.testIntersect(ray);
         if (intersection.hit) {
             return intersection;
@@ -186,9 +185,6 @@ void PDFIntegrator::createAndSaveDataPoint(
     for (int i = 0; i < spp; i++) {
         renderPDF(radianceLookup, scene, intersection);
 
-        std::mutex &lock = image.getLock();
-        lock.lock();
-
         for (int row = 0; row < height; row++) {
             for (int col = 0; col < width; col++) {
                 int index = 3 * (row * width + col);
@@ -202,9 +198,8 @@ void PDFIntegrator::createAndSaveDataPoint(
             }
         }
 
-        lock.unlock();
-
         image.setSpp(i + 1);
+        image.publish();
     }
 
     std::ostringstream filenameStream;
@@ -244,7 +239,7 @@ void PDFIntegrator::savePhotonBundle(
     std::ostringstream filenameStream;
     filenameStream << "photon-bundle_" << zeroPad(pointID, 5) << suffix;
 
-    photonPDF.save(filenameStream.str(), intersection.worldToTangent);
+    photonPDF.save(filenameStream.str(), intersection.frame().toLocalTransform());
     // printf("Saved photon bundle\n");
 }
 
@@ -259,10 +254,16 @@ void PDFIntegrator::renderPDF(
     BounceController bounceController(1, 1);
     PathTracer pathTracer(bounceController);
 
-    RandomGenerator random;
+    // One stream per phi step, so threads never share generator state
+    const uint64_t seed = g_job->seed();
+
+    // Build the shared frame before the threads start reading it
+    const ShadingFrame &frame = intersection.frame();
 
     #pragma omp parallel for
     for (int phiStep = 0; phiStep < phiSteps; phiStep++) {
+        RandomGenerator random(seed, phiStep);
+
         for (int thetaStep = 0; thetaStep < thetaSteps; thetaStep++) {
             float phi = M_TWO_PI * (phiStep + random.next()) / phiSteps;
             float theta = (M_PI / 2.f) * (thetaStep + random.next()) / thetaSteps;
@@ -272,7 +273,7 @@ void PDFIntegrator::renderPDF(
             float z = sinf(theta) * sinf(phi);
 
             Vector3 wiHemisphere(x, y, z);
-            Vector3 wiWorld = intersection.tangentToWorld.apply(wiHemisphere);
+            Vector3 wiWorld = frame.toWorld(wiHemisphere);
 
             Ray ray = Ray(intersection.point, wiWorld);
             const Intersection fisheyeIntersection = scene.testIntersect(ray);
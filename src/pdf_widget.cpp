@@ -3,7 +3,9 @@
 #include "bounce_controller.h"
 #include "camera.h"
 #include "color.h"
+#include "globals.h"
 #include "intersection.h"
+#include "job.h"
 #include "path_tracer.h"
 #include "random_generator.h"
 #include "ray.h"
@@ -26,12 +28,18 @@ std::shared_ptr<Image> renderPDF(
     BounceController bounceController(1, 1);
     PathTracer pathTracer(bounceController);
 
-    RandomGenerator random;
+    // One stream per phi step, so threads never share generator state
+    const uint64_t seed = g_job->seed();
 
     const int spp = 16;
 
+    // Build the shared frame before the threads start reading it
+    const ShadingFrame &frame = intersection.frame();
+
     #pragma omp parallel for
     for (int phiStep = 0; phiStep < phiSteps; phiStep++) {
+        RandomGenerator random(seed, phiStep);
+
         for (int thetaStep = 0; thetaStep < thetaSteps; thetaStep++) {
             Color sampleL(0.f);
 
@@ -44,7 +52,7 @@ std::shared_ptr<Image> renderPDF(
                 float z = sinf(theta) * sinf(phi);
 
                 Vector3 wiHemisphere(x, y, z);
-                Vector3 wiWorld = intersection.tangentToWorld.apply(wiHemisphere);
+                Vector3 wiWorld = frame.toWorld(wiHemisphere);
 
                 Ray ray = Ray(intersection.point, wiWorld);
                 const Intersection fisheyeIntersection = scene.testIntersect(ray);
@@ -66,5 +74,6 @@ std::shared_ptr<Image> renderPDF(
         }
     }
 
+    image->publish();
     return image;
 }
@@ -27,7 +27,7 @@ BSDFSample PerfectTransmission::sample(
     RandomGenerator &random
 ) const
 {
-    Vector3 localWo = intersection.worldToTangent.apply(intersection.woWorld);
+    Vector3 localWo = intersection.frame().toLocal(intersection.woWorld);
     Vector3 localWi(0.f);
 
     float etaIncident = 1.f;
@@ -45,14 +45,14 @@ BSDFSample PerfectTransmission::sample(
 
     if (doesRefract) {
         return {
-            .wiWorld = intersection.tangentToWorld.apply(localWi),
+            .wiWorld = intersection.frame().toWorld(localWi),
             .pdf = 1.f,
             .throughput = Color(1.f / TangentFrame::absCosTheta(localWi)),
             .material = this
         };
     } else {
         return {
-            .wiWorld = intersection.tangentToWorld.apply(localWi),
+            .wiWorld = intersection.frame().toWorld(localWi),
             .pdf = 1.f,
             .throughput = Color(1.f),
             .material = this
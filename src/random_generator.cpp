@@ -1,11 +1,80 @@
 #include "random_generator.h"
 
-// FIXME: Not sure why, but m_distribution was returning an inclusive 1
+#include <random>
+
+static const uint64_t PCGMultiplier = 6364136223846793005ULL;
+
+// splitmix64 finalizer, so that neighbouring seeds start far apart
+static uint64_t mixSeed(uint64_t value)
+{
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
 RandomGenerator::RandomGenerator()
-    : m_generator(m_device()), m_distribution(0.f, 1.f - std::numeric_limits<float>::epsilon())
-{}
+{
+    std::random_device device;
+    const uint64_t seed = (uint64_t(device()) << 32) | device();
+    reseed(seed, 0);
+}
+
+RandomGenerator::RandomGenerator(uint64_t seed, uint64_t stream)
+{
+    reseed(seed, stream);
+}
+
+void RandomGenerator::reseed(uint64_t seed, uint64_t stream)
+{
+    m_state = 0;
+    m_increment = (stream << 1) | 1;
+    nextUInt();
+    m_state += mixSeed(seed);
+    nextUInt();
+}
 
+uint32_t RandomGenerator::nextUInt()
+{
+    const uint64_t oldState = m_state;
+    m_state = oldState * PCGMultiplier + m_increment;
+
+    const uint32_t xorShifted = ((oldState >> 18) ^ oldState) >> 27;
+    const uint32_t rotation = oldState >> 59;
+    return (xorShifted >> rotation) | (xorShifted << ((-rotation) & 31));
+}
+
+// Brown, "Random Number Generation with Arbitrary Strides" (1994)
+void RandomGenerator::advance(uint64_t delta)
+{
+    uint64_t currentMultiplier = PCGMultiplier;
+    uint64_t currentIncrement = m_increment;
+
+    uint64_t accumulatedMultiplier = 1;
+    uint64_t accumulatedIncrement = 0;
+
+    while (delta > 0) {
+        if (delta & 1) {
+            accumulatedMultiplier *= currentMultiplier;
+            accumulatedIncrement = accumulatedIncrement * currentMultiplier + currentIncrement;
+        }
+        currentIncrement = (currentMultiplier + 1) * currentIncrement;
+        currentMultiplier *= currentMultiplier;
+        delta >>= 1;
+    }
+
+    m_state = accumulatedMultiplier * m_state + accumulatedIncrement;
+}
+
+// Top 24 bits map exactly onto floats in [0, 1), never returning 1
 float RandomGenerator::next()
 {
-    return m_distribution(m_generator);
+    return (nextUInt() >> 8) * 0x1p-24f;
+}
+
+std::array<float, 2> RandomGenerator::next2D()
+{
+    const float xi1 = next();
+    const float xi2 = next();
+    return { xi1, xi2 };
 }
@@ -0,0 +1,102 @@
+#include "render_stats.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+const int RenderCounters::PathLengthBuckets;
+
+RenderCounters::RenderCounters()
+    : primaryRays(0),
+      intersectRays(0),
+      shadowRays(0),
+      volumetricIntersectRays(0),
+      volumetricOcclusionRays(0),
+      mediumSteps(0),
+      lightSamples(0),
+      primaryNanoseconds(0),
+      pathLengths()
+{}
+
+void RenderCounters::merge(const RenderCounters &other)
+{
+    primaryRays += other.primaryRays;
+    intersectRays += other.intersectRays;
+    shadowRays += other.shadowRays;
+    volumetricIntersectRays += other.volumetricIntersectRays;
+    volumetricOcclusionRays += other.volumetricOcclusionRays;
+    mediumSteps += other.mediumSteps;
+    lightSamples += other.lightSamples;
+    primaryNanoseconds += other.primaryNanoseconds;
+
+    for (int i = 0; i < PathLengthBuckets; i++) {
+        pathLengths[i] += other.pathLengths[i];
+    }
+}
+
+void RenderCounters::recordPathLength(int segments)
+{
+    pathLengths[std::min(segments, PathLengthBuckets - 1)] += 1;
+}
+
+nlohmann::json RenderCounters::toJSON(double renderSeconds) const
+{
+    const double mraysPerSecond = renderSeconds > 0.0
+        ? totalRays() / renderSeconds / 1e6
+        : 0.0;
+
+    const double primarySeconds = primaryNanoseconds * 1e-9;
+    const double primaryMraysPerThreadSecond = primarySeconds > 0.0
+        ? primaryRays / primarySeconds / 1e6
+        : 0.0;
+
+    return {
+        { "render_seconds", renderSeconds },
+        { "mrays_per_second", mraysPerSecond },
+        { "rays", {
+            { "total", totalRays() },
+            { "primary", primaryRays },
+            { "extension", extensionRays() },
+            { "shadow", shadowRays },
+            { "volumetric", volumetricRays() },
+        }},
+        { "primary_stage", {
+            { "thread_seconds", primarySeconds },
+            { "mrays_per_thread_second", primaryMraysPerThreadSecond },
+        }},
+        { "medium_steps", mediumSteps },
+        { "light_samples", lightSamples },
+        { "path_lengths", pathLengths },
+    };
+}
+
+// Counters outlive their threads so nothing is lost if OpenMP retires one
+static std::mutex registryLock;
+static std::vector<std::unique_ptr<RenderCounters> > registry;
+
+static RenderCounters *registerThread()
+{
+    std::lock_guard<std::mutex> guard(registryLock);
+
+    registry.push_back(std::make_unique<RenderCounters>());
+    return registry.back().get();
+}
+
+RenderCounters &RenderStats::local()
+{
+    static thread_local RenderCounters *counters = registerThread();
+    return *counters;
+}
+
+RenderCounters RenderStats::collect()
+{
+    std::lock_guard<std::mutex> guard(registryLock);
+
+    RenderCounters total;
+    for (auto &counters : registry) {
+        total.merge(*counters);
+        *counters = RenderCounters();
+    }
+    return total;
+}
@@ -2,6 +2,7 @@
 
 #include <assert.h>
 #include <iostream>
+#include <set>
 
 RTCManager::RTCManager(RTCScene rootScene)
     : m_rootScene(rootScene)
@@ -36,58 +37,113 @@ void RTCManager::registerInstancedSurfaces(
     m_rtcSceneLookup[{rtcScene, rtcGeometryID}] = rtcInstanceScene;
 }
 
-std::shared_ptr<Surface> RTCManager::lookupInstancedSurface(
-    int rtcGeometryID,
-    int rtcPrimitiveID,
-    unsigned int *rtcInstanceIDs
-) const {
-    int i = 0;
-    RTCScene rtcCurrentScene = m_rootScene;
-    while (rtcInstanceIDs[i] != RTC_INVALID_GEOMETRY_ID && i < 2) {
-        // const NestedSurfaceVector &sceneSurfaces = m_rtcSceneToSurfaces.at(rtcCurrentScene);
-        // const std::vector<std::shared_ptr<Surface> > &geometrySurfaces = sceneSurfaces.at(rtcInstanceID);
+void RTCManager::bakeLookupTables()
+{
+    std::map<RTCScene, int> sceneBases;
 
-        // assert(geometrySurfaces.size() == 0);
+    // Root first so it lands at base 0
+    int geometryCount = 0;
+    sceneBases[m_rootScene] = geometryCount;
+    geometryCount += m_rtcSceneToSurfaces.at(m_rootScene).size();
+    for (const auto &item : m_rtcSceneToSurfaces) {
+        if (item.first == m_rootScene) { continue; }
 
-        rtcCurrentScene = m_rtcSceneLookup.at({rtcCurrentScene, rtcInstanceIDs[i]});
-        i++;
+        sceneBases[item.first] = geometryCount;
+        geometryCount += item.second.size();
     }
 
-    return lookupSurface(rtcCurrentScene, rtcGeometryID, rtcPrimitiveID);
+    m_geometries.assign(geometryCount, { -1, -1, nullptr });
+    m_surfaces.clear();
+
+    for (const auto &item : m_rtcSceneToSurfaces) {
+        const int base = sceneBases.at(item.first);
+        const NestedSurfaceVector &sceneSurfaces = item.second;
+
+        for (size_t geometryID = 0; geometryID < sceneSurfaces.size(); geometryID++) {
+            GeometryEntry &entry = m_geometries[base + geometryID];
+            entry.surfaceOffset = m_surfaces.size();
+            entry.rtcGeometry = rtcGetGeometry(item.first, geometryID);
+
+            for (const auto &surface : sceneSurfaces[geometryID]) {
+                m_surfaces.push_back(surface.get());
+            }
+        }
+    }
+
+    for (const auto &item : m_rtcSceneLookup) {
+        const int base = sceneBases.at(item.first.first);
+        m_geometries[base + item.first.second].instanceBase = sceneBases.at(item.second);
+    }
 }
 
-std::shared_ptr<Surface> RTCManager::lookupSurface(int rtcGeometryID, int rtcPrimitiveID) const
+int RTCManager::resolveInstanceBase(const unsigned int *rtcInstanceIDs) const
 {
-    return lookupSurface(m_rootScene, rtcGeometryID, rtcPrimitiveID);
+    int base = 0;
+    for (int level = 0; level < RTC_MAX_INSTANCE_LEVEL_COUNT; level++) {
+        if (rtcInstanceIDs[level] == RTC_INVALID_GEOMETRY_ID) { break; }
+        base = m_geometries[base + rtcInstanceIDs[level]].instanceBase;
+    }
+    return base;
+}
+
+const Surface *RTCManager::lookupInstancedSurface(
+    int rtcGeometryID,
+    int rtcPrimitiveID,
+    unsigned int *rtcInstanceIDs
+) const {
+    const GeometryEntry &entry = m_geometries[resolveInstanceBase(rtcInstanceIDs) + rtcGeometryID];
+    return m_surfaces[entry.surfaceOffset + rtcPrimitiveID];
 }
 
-std::shared_ptr<Surface> RTCManager::lookupSurface(RTCScene rtcScene, int rtcGeometryID, int rtcPrimitiveID) const
+const Surface *RTCManager::lookupSurface(int rtcGeometryID, int rtcPrimitiveID) const
 {
-    const NestedSurfaceVector &sceneSurfaces = m_rtcSceneToSurfaces.at(rtcScene);
-    const std::vector<std::shared_ptr<Surface> > &geometrySurfaces = sceneSurfaces.at(rtcGeometryID);
-    return geometrySurfaces.at(rtcPrimitiveID);
+    return m_surfaces[m_geometries[rtcGeometryID].surfaceOffset + rtcPrimitiveID];
 }
 
 RTCGeometry RTCManager::lookupGeometry(
     int rtcGeometryID,
     unsigned int *rtcInstanceIDs
 ) const {
-    int i = 0;
-    RTCScene rtcCurrentScene = m_rootScene;
-    while (rtcInstanceIDs[i] != RTC_INVALID_GEOMETRY_ID && i < 2) {
-        rtcCurrentScene = m_rtcSceneLookup.at({rtcCurrentScene, rtcInstanceIDs[i]});
-        i++;
-    }
-
-    return rtcGetGeometry(rtcCurrentScene, rtcGeometryID);
+    return m_geometries[resolveInstanceBase(rtcInstanceIDs) + rtcGeometryID].rtcGeometry;
 }
 
 void RTCManager::registerFilters(void (&callback)(const RTCFilterFunctionNArguments *))
 {
+    std::set<RTCScene> modifiedScenes;
+
     for (auto &pair : m_rtcRegistrationQueue) {
+        const auto &surfaces = m_rtcSceneToSurfaces.at(pair.first)[pair.second];
+
+        // Containers without a medium block rays like any other surface,
+        // the filter leaves them alone and so must the mask
+        size_t boundaryCount = 0;
+        for (const auto &surface : surfaces) {
+            if (surface->getMaterial()->isContainer() && surface->getInternalMedium()) {
+                boundaryCount += 1;
+            }
+        }
+        if (boundaryCount == 0) { continue; }
+
         const RTCGeometry rtcGeometry = rtcGetGeometry(pair.first, pair.second);
         rtcSetGeometryIntersectFilterFunction(rtcGeometry, callback);
         rtcSetGeometryOccludedFilterFunction(rtcGeometry, callback);
+
+        // Geometry mixing boundaries with regular surfaces keeps the default
+        // mask and leaves the sorting to the filter
+        if (boundaryCount == surfaces.size()) {
+            rtcSetGeometryMask(rtcGeometry, RTCMask::Boundary);
+        }
+
+        rtcCommitGeometry(rtcGeometry);
+        modifiedScenes.insert(pair.first);
+    }
+
+    // Instanced scenes were committed while parsing, the root scene is
+    // committed once everything is registered
+    for (RTCScene rtcScene : modifiedScenes) {
+        if (rtcScene != m_rootScene) {
+            rtcCommitScene(rtcScene);
+        }
     }
 }
 
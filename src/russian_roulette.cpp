@@ -0,0 +1,58 @@
+#include "russian_roulette.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+
+RussianRoulette::RussianRoulette()
+    : m_startBounce(-1),
+      m_minWeight(0.f),
+      m_maxWeight(0.f),
+      m_maxSplit(1)
+{}
+
+RussianRoulette::RussianRoulette(
+    int startBounce,
+    float minWeight,
+    float maxWeight,
+    int maxSplit
+) : m_startBounce(startBounce),
+    m_minWeight(minWeight),
+    m_maxWeight(maxWeight),
+    m_maxSplit(maxSplit)
+{
+    assert(m_minWeight >= 0.f);
+    assert(m_maxWeight == 0.f || m_minWeight <= m_maxWeight);
+    assert(m_maxSplit >= 1);
+}
+
+int RussianRoulette::evaluate(
+    int bounce,
+    const Color &throughput,
+    RandomGenerator &random,
+    float *weight
+) const {
+    *weight = 1.f;
+
+    if (!enabled() || bounce < m_startBounce) { return 1; }
+
+    const float pathWeight = throughput.luminance();
+
+    if (pathWeight < m_minWeight) {
+        const float survivalProbability = pathWeight / m_minWeight;
+        if (random.next() >= survivalProbability) { return 0; }
+
+        *weight = 1.f / survivalProbability;
+        return 1;
+    }
+
+    // A max weight of 0 leaves splitting off
+    if (m_maxWeight > 0.f && pathWeight > m_maxWeight && m_maxSplit > 1) {
+        const int copies = std::min(m_maxSplit, (int)std::ceil(pathWeight / m_maxWeight));
+
+        *weight = 1.f / copies;
+        return copies;
+    }
+
+    return 1;
+}
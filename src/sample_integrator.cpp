@@ -3,26 +3,93 @@
 #include "camera.h"
 #include "globals.h"
 #include "job.h"
+#include "logger.h"
+#include "render_stats.h"
+#include "sampler.h"
+#include "tile_scheduler.h"
 #include "volume_helper.h"
 
 #include "omp.h"
 
-void SampleIntegrator::samplePixel(
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <utility>
+
+void SampleIntegrator::traceCameraRays(
+    const Tile &tile,
+    int width,
+    const Accumulator &accumulator,
+    const Scene &scene,
+    Sampler &sampler,
+    CameraRays &cameraRays
+) {
+    const auto begin = std::chrono::steady_clock::now();
+
+    cameraRays.pixelIndices.clear();
+    cameraRays.dimensions.clear();
+    cameraRays.rays.clear();
+
+    for (int row = tile.startRow; row < tile.endRow; row++) {
+        for (int col = tile.startCol; col < tile.endCol; col++) {
+            const int pixelIndex = row * width + col;
+            if (!accumulator.isActive(pixelIndex)) { continue; }
+
+            // Converged neighbours fall behind, so index the sequence by
+            // the pixel's own sample count
+            sampler.startPixelSample(pixelIndex, accumulator.sampleCount(pixelIndex));
+
+            cameraRays.pixelIndices.push_back(pixelIndex);
+            cameraRays.rays.push_back(scene.getCamera()->generateRay(row, col, sampler));
+            cameraRays.dimensions.push_back(sampler.dimension());
+        }
+    }
+
+    const int count = cameraRays.rays.size();
+    cameraRays.intersections.resize(count, IntersectionHelper::miss);
+
+    if (g_job->packetPrimaryRays()) {
+        scene.testIntersectPacket(
+            cameraRays.rays.data(),
+            count,
+            cameraRays.intersections.data()
+        );
+    } else {
+        for (int i = 0; i < count; i++) {
+            cameraRays.intersections[i] = scene.testIntersect(cameraRays.rays[i]);
+        }
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+
+    RenderCounters &counters = RenderStats::local();
+    counters.primaryRays += count;
+    counters.primaryNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        end - begin
+    ).count();
+}
+
+Color SampleIntegrator::shadePixel(
     int row, int col,
     int width, int height,
-    std::vector<float> &radianceLookup,
-    std::vector<Sample> &sampleLookup,
+    const Ray &ray,
+    const Intersection &intersection,
+    SampleLookup &sampleLookup,
     const Scene &scene,
-    RandomGenerator &random
+    RandomGenerator &random,
+    ShadowQueue &shadowQueue
 ) {
-    Ray ray = scene.getCamera()->generateRay(row, col);
+    // The camera ray was traced with the rest of its tile
+    RenderCounters &counters = RenderStats::local();
+    const uint64_t segmentsBefore = counters.segmentRays() - 1;
 
     Color color(0.f);
 
-    Intersection intersection = scene.testIntersect(ray);
     if (intersection.hit) {
-        Sample sample;
-        sample.eyePoints.push_back(ray.origin());
+        auto captured = sampleLookup.find(row * width + col);
+        Sample sample(captured != sampleLookup.end());
+        sample.recordEyePoint(ray.origin());
 
         if (g_job->bounceController().checkCounts(0)) {
             Color emit = intersection.material->emit();
@@ -30,7 +97,7 @@ void SampleIntegrator::samplePixel(
                 color += emit;
             }
 
-            sample.contributions.push_back({color, 1.f});
+            sample.recordContribution({color, 1.f});
 
             if (intersection.material->isContainer()) {
                 const IntersectionResult volumetricResult = scene.testVolumetricIntersect(ray);
@@ -50,17 +117,18 @@ void SampleIntegrator::samplePixel(
             }
         }
 
-        color += L(intersection, scene, random, row * width + col, sample);
+        color += queuedL(intersection, scene, random, row * width + col, sample, shadowQueue);
 
-        sampleLookup[row * width + col] = sample;
+        if (sample.recording) {
+            // The entry already exists, so threads never modify the map itself
+            captured->second = std::move(sample);
+        }
     } else {
         // color += Color(0.1f, 0.2f, 0.5f);
         color += scene.environmentL(ray.direction());
     }
 
-    radianceLookup[3 * (row * width + col) + 0] += color.r();
-    radianceLookup[3 * (row * width + col) + 1] += color.g();
-    radianceLookup[3 * (row * width + col) + 2] += color.b();
+    counters.recordPathLength(counters.segmentRays() - segmentsBefore);
 
     // radianceLookup[3 * (row * width + col) + 0] += intersection.uv.u;
     // radianceLookup[3 * (row * width + col) + 1] += intersection.uv.v;
@@ -75,39 +143,95 @@ void SampleIntegrator::samplePixel(
     // radianceLookup[3 * (row * width + col) + 0] += 0.5f * (normal.x() + 1.f);
     // radianceLookup[3 * (row * width + col) + 1] += 0.5f * (normal.y() + 1.f);
     // radianceLookup[3 * (row * width + col) + 2] += 0.5f * (normal.z() + 1.f);
+
+    return color;
 }
 
 void SampleIntegrator::sampleImage(
-    std::vector<float> &radianceLookup,
-    std::vector<Sample> &sampleLookup,
+    Accumulator &accumulator,
+    SampleLookup &sampleLookup,
     Scene &scene,
-    RandomGenerator &random
+    RandomGenerator &random,
+    int sampleIndex
 ) {
     const int width = g_job->width();
     const int height = g_job->height();
 
-    // samplePixel(
-    //     400 - 184 - 1, 97, // 0.0827, 0.0068, 0.0017
-    //     width, height,
-    //     radianceLookup,
-    //     sampleLookup,
-    //     scene,
-    //     random
-    // );
-    // std::cout << "DONE!" << std::endl;
-
-    #pragma omp parallel for
-    for (int row = 0; row < height; row++) {
-        for (int col = 0; col < width; col++) {
-            samplePixel(
-                row, col,
-                width, height,
-                radianceLookup,
-                sampleLookup,
-                scene,
-                random
+    TileScheduler scheduler(g_job->cropWindow(), g_job->tileSize());
+    scheduler.reset(omp_get_max_threads());
+
+    #pragma omp parallel
+    {
+        const int workerID = omp_get_thread_num();
+
+        std::unique_ptr<Sampler> sampler = g_job->sampler();
+        CameraRays cameraRays;
+        ShadowQueue shadowQueue;
+        std::vector<Color> colors;
+
+        int tileIndex;
+        while (scheduler.next(workerID, &tileIndex)) {
+            const auto begin = std::chrono::steady_clock::now();
+
+            const Tile &tile = scheduler.tile(tileIndex);
+            traceCameraRays(tile, width, accumulator, scene, *sampler, cameraRays);
+
+            const int pixelCount = cameraRays.pixelIndices.size();
+            colors.assign(pixelCount, Color(0.f));
+
+            if (AOVBuffer *aovs = aovBuffer()) {
+                for (int i = 0; i < pixelCount; i++) {
+                    aovs->add(cameraRays.pixelIndices[i], cameraRays.intersections[i]);
+                }
+            }
+
+            for (int i = 0; i < pixelCount; i++) {
+                const int pixelIndex = cameraRays.pixelIndices[i];
+
+                sampler->resumePixelSample(
+                    pixelIndex,
+                    accumulator.sampleCount(pixelIndex),
+                    cameraRays.dimensions[i]
+                );
+
+                shadowQueue.setOwner(i);
+                colors[i] = shadePixel(
+                    pixelIndex / width, pixelIndex % width,
+                    width, height,
+                    cameraRays.rays[i],
+                    cameraRays.intersections[i],
+                    sampleLookup,
+                    scene,
+                    *sampler,
+                    shadowQueue
+                );
+            }
+
+            // The whole tile's shadow rays go out together
+            shadowQueue.resolve(scene, colors);
+
+            for (int i = 0; i < pixelCount; i++) {
+                accumulator.add(cameraRays.pixelIndices[i], colors[i]);
+            }
+
+            const auto end = std::chrono::steady_clock::now();
+            scheduler.recordTime(
+                workerID,
+                tileIndex,
+                std::chrono::duration<double>(end - begin).count()
             );
-            // std::cout << "row: " << row << " col: " << col << std::endl;
         }
     }
+
+    const TileStats stats = scheduler.stats();
+
+    std::ostringstream statsStream;
+    statsStream << "tiles: " << stats.tileCount
+                << std::fixed << std::setprecision(2)
+                << " (mean " << stats.meanTileSeconds * 1000.0 << "ms"
+                << ", max " << stats.maxTileSeconds * 1000.0 << "ms"
+                << ", steals " << stats.stealCount
+                << ", imbalance " << stats.imbalance() << "x"
+                << ", " << (g_job->packetPrimaryRays() ? scene.packetWidth() : 1) << "-wide camera rays)";
+    Logger::line(statsStream.str());
 }
@@ -0,0 +1,32 @@
+#include "sampler.h"
+
+Sampler::Sampler(uint64_t seed)
+    : RandomGenerator(seed, 0),
+      m_seed(seed),
+      m_pixelIndex(0),
+      m_sampleIndex(0),
+      m_dimension(0)
+{}
+
+void Sampler::startPixelSample(int pixelIndex, int sampleIndex)
+{
+    m_pixelIndex = pixelIndex;
+    m_sampleIndex = sampleIndex;
+    m_dimension = 0;
+
+    reseed(m_seed + sampleIndex, pixelIndex);
+}
+
+void Sampler::resumePixelSample(int pixelIndex, int sampleIndex, int dimension)
+{
+    startPixelSample(pixelIndex, sampleIndex);
+
+    advance(streamPosition(dimension));
+    m_dimension = dimension;
+}
+
+float Sampler::next()
+{
+    m_dimension += 1;
+    return RandomGenerator::next();
+}
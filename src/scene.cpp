@@ -5,6 +5,8 @@
 #include "globals.h"
 #include "intersection.h"
 #include "ray.h"
+#include "render_stats.h"
+#include "trace.h"
 #include "util.h"
 #include "uv.h"
 #include "world_frame.h"
@@ -32,13 +34,26 @@ Scene::Scene(
     : m_rtcManagerPtr(std::move(rtcManagerPtr)),
       m_lights(lights),
       m_environmentLight(environmentLight),
-      m_camera(camera)
+      m_camera(camera),
+      m_packetWidth(1)
 {
     registerOcclusionFilters();
+    m_rtcManagerPtr->bakeLookupTables();
+
+    // Prefer the widest packet the ISA Embree picked at runtime handles
+    // natively; emulated packets are slower than single rays
+    if (rtcGetDeviceProperty(g_rtcDevice, RTC_DEVICE_PROPERTY_NATIVE_RAY16_SUPPORTED)) {
+        m_packetWidth = 16;
+    } else if (rtcGetDeviceProperty(g_rtcDevice, RTC_DEVICE_PROPERTY_NATIVE_RAY8_SUPPORTED)) {
+        m_packetWidth = 8;
+    }
 
+    Trace::Scope commitScope("rtcCommitScene");
     rtcCommitScene(g_rtcScene);
 }
 
+// Only installed on geometry carrying media boundaries. Stream queries may
+// hand us several rays at once, so walk all N lanes
 static void occlusionFilter(const RTCFilterFunctionNArguments *args)
 {
     if (args->context == nullptr) { return; }
@@ -46,41 +61,41 @@ static void occlusionFilter(const RTCFilterFunctionNArguments *args)
     CustomRTCIntersectContext *context = (CustomRTCIntersectContext *)args->context;
     if (context->shouldIntersectPassthroughs) { return; }
 
-    RTCHit *hit = (RTCHit *)args->hit;
-    if (hit == nullptr) { return; }
+    if (args->hit == nullptr) { return; }
 
-    const auto &surfacePtr = (hit->instID[0] == RTC_INVALID_GEOMETRY_ID)
-        ? context->rtcManagerPtr->lookupSurface(hit->geomID, hit->primID)
-        : context->rtcManagerPtr->lookupInstancedSurface(
-            hit->geomID,
-            hit->primID,
-            hit->instID
-        )
-    ;
+    const unsigned int N = args->N;
+    for (unsigned int i = 0; i < N; i++) {
+        if (args->valid[i] != -1) { continue; }
 
-    if (!surfacePtr->getMaterial()->isContainer()) { return; }
+        const unsigned int geomID = RTCHitN_geomID(args->hit, N, i);
+        const unsigned int primID = RTCHitN_primID(args->hit, N, i);
 
-    std::shared_ptr<Medium> mediumPtr = surfacePtr->getInternalMedium();
-    if (!mediumPtr) { return; }
+        unsigned int instIDs[RTC_MAX_INSTANCE_LEVEL_COUNT];
+        for (int level = 0; level < RTC_MAX_INSTANCE_LEVEL_COUNT; level++) {
+            instIDs[level] = RTCHitN_instID(args->hit, N, i, level);
+        }
 
-    RTCRay *ray = (RTCRay *)args->ray;
-    VolumeEvent event({
-        ray->tfar,
-        mediumPtr
-    });
+        const Surface *surface = (instIDs[0] == RTC_INVALID_GEOMETRY_ID)
+            ? context->rtcManagerPtr->lookupSurface(geomID, primID)
+            : context->rtcManagerPtr->lookupInstancedSurface(
+                geomID,
+                primID,
+                instIDs
+            )
+        ;
 
-    bool validEvent = true;
-    for (const VolumeEvent &existingEvent : context->volumeEvents) {
-        if (event.t == existingEvent.t) {
-            validEvent = false;
-        }
-    }
+        if (!surface->getMaterial()->isContainer()) { continue; }
 
-    if (validEvent) {
-        context->volumeEvents.push_back(event);
-    }
+        const std::shared_ptr<Medium> &mediumPtr = surface->getInternalMedium();
+        if (!mediumPtr) { continue; }
 
-    args->valid[0] = 0;
+        context->volumeEvents.insert({
+            RTCRayN_tfar(args->ray, N, i),
+            mediumPtr.get()
+        });
+
+        args->valid[i] = 0;
+    }
 }
 
 void Scene::registerOcclusionFilters() const
@@ -88,9 +103,10 @@ void Scene::registerOcclusionFilters() const
     m_rtcManagerPtr->registerFilters(occlusionFilter);
 }
 
-Intersection Scene::testIntersect(const Ray &ray) const
+static void initRayHit(const Ray &ray, RTCRayHit &rayHit)
 {
-    RTCRayHit rayHit;
+    // Closest hits always see boundaries: either the caller wants the
+    // container hit itself or the filter records it as a volume event
     rayHit.ray.org_x = ray.origin().x();
     rayHit.ray.org_y = ray.origin().y();
     rayHit.ray.org_z = ray.origin().z();
@@ -102,271 +118,322 @@ Intersection Scene::testIntersect(const Ray &ray) const
     rayHit.ray.tnear = 1e-3f;
     rayHit.ray.tfar = 1e5f;
 
+    rayHit.ray.time = 0.f;
+    rayHit.ray.mask = RTCMask::All;
     rayHit.ray.flags = 0;
 
     rayHit.hit.geomID = RTC_INVALID_GEOMETRY_ID;
     rayHit.hit.instID[0] = RTC_INVALID_GEOMETRY_ID;
+}
 
-    CustomRTCIntersectContext context;
-    InitCustomRTCIntersectContext(&context, true);
+static void initRay(const Ray &ray, float maxT, unsigned int mask, RTCRay &rtcRay)
+{
+    rtcRay.org_x = ray.origin().x();
+    rtcRay.org_y = ray.origin().y();
+    rtcRay.org_z = ray.origin().z();
 
-    rtcIntersect1(
-        g_rtcScene,
-        &context.context,
-        &rayHit
-    );
+    rtcRay.dir_x = ray.direction().x();
+    rtcRay.dir_y = ray.direction().y();
+    rtcRay.dir_z = ray.direction().z();
+
+    rtcRay.tnear = 1e-3f;
+    rtcRay.tfar = maxT - 1e-3f;
 
+    rtcRay.time = 0.f;
+    rtcRay.mask = mask;
+    rtcRay.flags = 0;
+}
+
+Intersection Scene::buildIntersection(
+    const Ray &ray,
+    const RTCRayHit &rayHit,
+    bool orientDoubleSided
+) const {
     const RTCHit &hit = rayHit.hit;
 
     // need parallel arrays of geometry and materials
-    if (hit.geomID != RTC_INVALID_GEOMETRY_ID) {
-        RTCGeometry geometry;
-        std::shared_ptr<Surface> surfacePtr;
-        if (rayHit.hit.instID[0] == RTC_INVALID_GEOMETRY_ID) {
-            geometry = rtcGetGeometry(g_rtcScene, hit.geomID);
-            surfacePtr = m_rtcManagerPtr->lookupSurface(
-                rayHit.hit.geomID,
-                rayHit.hit.primID
-            );
-        } else {
-            geometry = m_rtcManagerPtr->lookupGeometry(hit.geomID, rayHit.hit.instID);
-            surfacePtr = m_rtcManagerPtr->lookupInstancedSurface(
-                rayHit.hit.geomID,
-                rayHit.hit.primID,
-                rayHit.hit.instID
-            );
-        }
-        const auto &shapePtr = surfacePtr->getShape();
-
-        UV uv;
-        Vector3 geometricNormal(0.f, 0.f, 0.f);
-        Vector3 shadingNormal(0.f, 0.f, 0.f);
-        if (shapePtr->useBackwardsNormals()) {
-            rtcInterpolate0(
-                geometry,
-                hit.primID,
-                hit.u,
-                hit.v,
-                RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,
-                0,
-                &uv.u,
-                2
-            );
-
-            // if (surfacePtr->getFaceIndex() % 2 == 0) {
-            //     uv.u = hit.u * 0.f + hit.v * 0.f + (1.f - hit.u - hit.v) * 1.f;
-            //     uv.v = hit.u * 0.f + hit.v * 1.f + (1.f - hit.u - hit.v) * 0.f;
-            // } else {
-            //     uv.u = hit.u * 0.f + hit.v * 1.f + (1.f - hit.u - hit.v) * 1.f;
-            //     uv.v = hit.u * 1.f + hit.v * 1.f + (1.f - hit.u - hit.v) * 0.f;
-            // }
-            // uv.u = 1.f - uv.u;
-
-
-            float normalRaw[3];
-            rtcInterpolate0(
-                geometry,
-                hit.primID,
-                hit.u,
-                hit.v,
-                RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,
-                1,
-                &normalRaw[0],
-                3
-            );
-
-            shadingNormal = Vector3(normalRaw[0], normalRaw[1], normalRaw[2]);
-
-            geometricNormal = Vector3(
-                rayHit.hit.Ng_x,
-                rayHit.hit.Ng_y,
-                rayHit.hit.Ng_z
-            ).normalized();
-        } else {
-            // spheres
-            geometricNormal = Vector3(
-                rayHit.hit.Ng_x,
-                rayHit.hit.Ng_y,
-                rayHit.hit.Ng_z
-            ).normalized();
-        }
+    if (hit.geomID == RTC_INVALID_GEOMETRY_ID) {
+        return IntersectionHelper::miss;
+    }
 
-        if (shadingNormal.length() == 0.f) {
-            shadingNormal = geometricNormal;
-        }
+    RTCGeometry geometry;
+    const Surface *surface;
+    if (hit.instID[0] == RTC_INVALID_GEOMETRY_ID) {
+        geometry = rtcGetGeometry(g_rtcScene, hit.geomID);
+        surface = m_rtcManagerPtr->lookupSurface(
+            hit.geomID,
+            hit.primID
+        );
+    } else {
+        unsigned int instIDs[RTC_MAX_INSTANCE_LEVEL_COUNT];
+        std::copy(hit.instID, hit.instID + RTC_MAX_INSTANCE_LEVEL_COUNT, instIDs);
+
+        geometry = m_rtcManagerPtr->lookupGeometry(hit.geomID, instIDs);
+        surface = m_rtcManagerPtr->lookupInstancedSurface(
+            hit.geomID,
+            hit.primID,
+            instIDs
+        );
+    }
+    const Shape *shape = surface->getShape().get();
+
+    UV uv;
+    Vector3 geometricNormal(0.f, 0.f, 0.f);
+    Vector3 shadingNormal(0.f, 0.f, 0.f);
+    if (shape->useBackwardsNormals()) {
+        rtcInterpolate0(
+            geometry,
+            hit.primID,
+            hit.u,
+            hit.v,
+            RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,
+            0,
+            &uv.u,
+            2
+        );
 
-        if (surfacePtr->getMaterial()->doubleSided()) {
-            if (geometricNormal.dot(-ray.direction()) < 0.f) {
-                geometricNormal = -geometricNormal;
-            }
-            if (shadingNormal.dot(-ray.direction()) < 0.f) {
-                shadingNormal = -shadingNormal;
-            }
-        }
+        // if (surface->getFaceIndex() % 2 == 0) {
+        //     uv.u = hit.u * 0.f + hit.v * 0.f + (1.f - hit.u - hit.v) * 1.f;
+        //     uv.v = hit.u * 0.f + hit.v * 1.f + (1.f - hit.u - hit.v) * 0.f;
+        // } else {
+        //     uv.u = hit.u * 0.f + hit.v * 1.f + (1.f - hit.u - hit.v) * 1.f;
+        //     uv.v = hit.u * 1.f + hit.v * 1.f + (1.f - hit.u - hit.v) * 0.f;
+        // }
+        // uv.u = 1.f - uv.u;
+
+
+        float normalRaw[3];
+        rtcInterpolate0(
+            geometry,
+            hit.primID,
+            hit.u,
+            hit.v,
+            RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,
+            1,
+            &normalRaw[0],
+            3
+        );
+
+        shadingNormal = Vector3(normalRaw[0], normalRaw[1], normalRaw[2]);
 
-        Intersection hit = {
-            .hit = true,
-            .t = rayHit.ray.tfar,
-            .point = ray.at(rayHit.ray.tfar),
-            .woWorld = -ray.direction(),
-            .normal = geometricNormal,
-            .shadingNormal = shadingNormal.normalized(),
-            // .shadingNormal = geometricNormal,
-            .uv = uv,
-            .material = surfacePtr->getMaterial().get(),
-            .surface = surfacePtr.get()
-        };
-        return hit;
+        geometricNormal = Vector3(
+            hit.Ng_x,
+            hit.Ng_y,
+            hit.Ng_z
+        ).normalized();
     } else {
-        return IntersectionHelper::miss;
+        // spheres
+        geometricNormal = Vector3(
+            hit.Ng_x,
+            hit.Ng_y,
+            hit.Ng_z
+        ).normalized();
     }
+
+    if (shadingNormal.length() == 0.f) {
+        shadingNormal = geometricNormal;
+    }
+
+    if (orientDoubleSided && surface->getMaterial()->doubleSided()) {
+        if (geometricNormal.dot(-ray.direction()) < 0.f) {
+            geometricNormal = -geometricNormal;
+        }
+        if (shadingNormal.dot(-ray.direction()) < 0.f) {
+            shadingNormal = -shadingNormal;
+        }
+    }
+
+    Intersection intersection = {
+        .hit = true,
+        .t = rayHit.ray.tfar,
+        .point = ray.at(rayHit.ray.tfar),
+        .woWorld = -ray.direction(),
+        .normal = geometricNormal,
+        .shadingNormal = shadingNormal.normalized(),
+        // .shadingNormal = geometricNormal,
+        .uv = uv,
+        .material = surface->getMaterial().get(),
+        .surface = surface
+    };
+    return intersection;
 }
 
-IntersectionResult Scene::testVolumetricIntersect(const Ray &ray) const
+Intersection Scene::testIntersect(const Ray &ray) const
 {
+    RenderStats::local().intersectRays += 1;
+
     RTCRayHit rayHit;
-    rayHit.ray.org_x = ray.origin().x();
-    rayHit.ray.org_y = ray.origin().y();
-    rayHit.ray.org_z = ray.origin().z();
+    initRayHit(ray, rayHit);
 
-    rayHit.ray.dir_x = ray.direction().x();
-    rayHit.ray.dir_y = ray.direction().y();
-    rayHit.ray.dir_z = ray.direction().z();
+    CustomRTCIntersectContext context;
+    InitCustomRTCIntersectContext(&context, true);
 
-    rayHit.ray.tnear = 1e-3f;
-    rayHit.ray.tfar = 1e5f;
+    rtcIntersect1(
+        g_rtcScene,
+        &context.context,
+        &rayHit
+    );
 
-    rayHit.ray.flags = 0;
+    return buildIntersection(ray, rayHit, true);
+}
 
-    rayHit.hit.geomID = RTC_INVALID_GEOMETRY_ID;
-    rayHit.hit.instID[0] = RTC_INVALID_GEOMETRY_ID;
+void Scene::testIntersect(const Ray *rays, int count, Intersection *intersections) const
+{
+    RenderStats::local().intersectRays += count;
+
+    static thread_local std::vector<RTCRayHit> rayHits;
+    rayHits.resize(count);
+
+    for (int i = 0; i < count; i++) {
+        initRayHit(rays[i], rayHits[i]);
+    }
 
     CustomRTCIntersectContext context;
-    InitCustomRTCIntersectContext(&context, false);
+    InitCustomRTCIntersectContext(&context, true);
 
-    rtcIntersect1(
+    rtcIntersect1M(
         g_rtcScene,
         &context.context,
-        &rayHit
+        rayHits.data(),
+        count,
+        sizeof(RTCRayHit)
     );
 
-    const RTCHit &hit = rayHit.hit;
+    for (int i = 0; i < count; i++) {
+        intersections[i] = buildIntersection(rays[i], rayHits[i], true);
+    }
+}
 
-    // need parallel arrays of geometry and materials
-    if (hit.geomID != RTC_INVALID_GEOMETRY_ID) {
-        RTCGeometry geometry;
-        std::shared_ptr<Surface> surfacePtr;
-        if (rayHit.hit.instID[0] == RTC_INVALID_GEOMETRY_ID) {
-            geometry = rtcGetGeometry(g_rtcScene, hit.geomID);
-            surfacePtr = m_rtcManagerPtr->lookupSurface(
-                rayHit.hit.geomID,
-                rayHit.hit.primID
-            );
-        } else {
-            geometry = m_rtcManagerPtr->lookupGeometry(hit.geomID, rayHit.hit.instID);
-            surfacePtr = m_rtcManagerPtr->lookupInstancedSurface(
-                rayHit.hit.geomID,
-                rayHit.hit.primID,
-                rayHit.hit.instID
-            );
-        }
-        const auto &shapePtr = surfacePtr->getShape();
-
-        UV uv;
-        Vector3 geometricNormal(0.f, 0.f, 0.f);
-        Vector3 shadingNormal(0.f, 0.f, 0.f);
-        if (shapePtr->useBackwardsNormals()) {
-            rtcInterpolate0(
-                geometry,
-                hit.primID,
-                hit.u,
-                hit.v,
-                RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,
-                0,
-                &uv.u,
-                2
-            );
-
-            float normalRaw[3];
-            rtcInterpolate0(
-                geometry,
-                hit.primID,
-                hit.u,
-                hit.v,
-                RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,
-                1,
-                &normalRaw[0],
-                3
-            );
-
-            shadingNormal = Vector3(normalRaw[0], normalRaw[1], normalRaw[2]);
-
-            geometricNormal = Vector3(
-                rayHit.hit.Ng_x,
-                rayHit.hit.Ng_y,
-                rayHit.hit.Ng_z
-            ).normalized();
-        } else {
-            // spheres
-            geometricNormal = Vector3(
-                rayHit.hit.Ng_x,
-                rayHit.hit.Ng_y,
-                rayHit.hit.Ng_z
-            ).normalized();
+static void rtcIntersectN(
+    const int *valid,
+    RTCIntersectContext *context,
+    RTCRayHit8 *rayHits
+) {
+    rtcIntersect8(valid, g_rtcScene, context, rayHits);
+}
+
+static void rtcIntersectN(
+    const int *valid,
+    RTCIntersectContext *context,
+    RTCRayHit16 *rayHits
+) {
+    rtcIntersect16(valid, g_rtcScene, context, rayHits);
+}
+
+template <int N, typename RTCRayHitN>
+static void intersectPacket(
+    const Ray *rays,
+    int count,
+    RTCIntersectContext *context,
+    RTCRayHit *rayHits
+) {
+    alignas(64) int valid[N];
+    alignas(64) RTCRayHitN packet;
+
+    for (int i = 0; i < N; i++) {
+        valid[i] = i < count ? -1 : 0;
+        if (i >= count) { continue; }
+
+        RTCRayHit rayHit;
+        initRayHit(rays[i], rayHit);
+
+        packet.ray.org_x[i] = rayHit.ray.org_x;
+        packet.ray.org_y[i] = rayHit.ray.org_y;
+        packet.ray.org_z[i] = rayHit.ray.org_z;
+        packet.ray.dir_x[i] = rayHit.ray.dir_x;
+        packet.ray.dir_y[i] = rayHit.ray.dir_y;
+        packet.ray.dir_z[i] = rayHit.ray.dir_z;
+        packet.ray.tnear[i] = rayHit.ray.tnear;
+        packet.ray.tfar[i] = rayHit.ray.tfar;
+        packet.ray.time[i] = rayHit.ray.time;
+        packet.ray.mask[i] = rayHit.ray.mask;
+        packet.ray.flags[i] = rayHit.ray.flags;
+
+        packet.hit.geomID[i] = RTC_INVALID_GEOMETRY_ID;
+        packet.hit.instID[0][i] = RTC_INVALID_GEOMETRY_ID;
+    }
+
+    rtcIntersectN(valid, context, &packet);
+
+    for (int i = 0; i < count; i++) {
+        RTCRayHit &rayHit = rayHits[i];
+
+        rayHit.ray.tfar = packet.ray.tfar[i];
+
+        rayHit.hit.Ng_x = packet.hit.Ng_x[i];
+        rayHit.hit.Ng_y = packet.hit.Ng_y[i];
+        rayHit.hit.Ng_z = packet.hit.Ng_z[i];
+        rayHit.hit.u = packet.hit.u[i];
+        rayHit.hit.v = packet.hit.v[i];
+        rayHit.hit.primID = packet.hit.primID[i];
+        rayHit.hit.geomID = packet.hit.geomID[i];
+        for (int level = 0; level < RTC_MAX_INSTANCE_LEVEL_COUNT; level++) {
+            rayHit.hit.instID[level] = packet.hit.instID[level][i];
         }
+    }
+}
 
-        if (shadingNormal.length() == 0.f) {
-            shadingNormal = geometricNormal;
+void Scene::testIntersectPacket(const Ray *rays, int count, Intersection *intersections) const
+{
+    if (m_packetWidth == 1) {
+        for (int i = 0; i < count; i++) {
+            intersections[i] = testIntersect(rays[i]);
         }
+        return;
+    }
 
-        Intersection hit = {
-            .hit = true,
-            .t = rayHit.ray.tfar,
-            .point = ray.at(rayHit.ray.tfar),
-            .woWorld = -ray.direction(),
-            .normal = geometricNormal,
-            .shadingNormal = shadingNormal.normalized(),
-            // .shadingNormal = geometricNormal,
-            .uv = uv,
-            .material = surfacePtr->getMaterial().get(),
-            .surface = surfacePtr.get()
-        };
-
-        std::sort(
-            context.volumeEvents.begin(),
-            context.volumeEvents.end(),
-            [](VolumeEvent ve1, VolumeEvent ve2) {
-                return ve1.t < ve2.t;
-            }
-        );
+    RenderStats::local().intersectRays += count;
 
-        return IntersectionResult({
-            hit,
-            context.volumeEvents
-        });
-    } else {
-        return IntersectionResult({
-            IntersectionHelper::miss,
-            context.volumeEvents
-        });
+    CustomRTCIntersectContext context;
+    InitCustomRTCIntersectContext(&context, true);
+    context.context.flags = RTC_INTERSECT_CONTEXT_FLAG_COHERENT;
+
+    RTCRayHit rayHits[16];
+    for (int begin = 0; begin < count; begin += m_packetWidth) {
+        const int packetCount = std::min(m_packetWidth, count - begin);
+
+        if (m_packetWidth == 16) {
+            intersectPacket<16, RTCRayHit16>(&rays[begin], packetCount, &context.context, rayHits);
+        } else {
+            intersectPacket<8, RTCRayHit8>(&rays[begin], packetCount, &context.context, rayHits);
+        }
+
+        for (int i = 0; i < packetCount; i++) {
+            intersections[begin + i] = buildIntersection(rays[begin + i], rayHits[i], true);
+        }
     }
 }
 
-bool Scene::testOcclusion(const Ray &ray, float maxT) const
+IntersectionResult Scene::testVolumetricIntersect(const Ray &ray) const
 {
-    RTCRay rtcRay;
-    rtcRay.org_x = ray.origin().x();
-    rtcRay.org_y = ray.origin().y();
-    rtcRay.org_z = ray.origin().z();
+    RenderStats::local().volumetricIntersectRays += 1;
 
-    rtcRay.dir_x = ray.direction().x();
-    rtcRay.dir_y = ray.direction().y();
-    rtcRay.dir_z = ray.direction().z();
+    RTCRayHit rayHit;
+    initRayHit(ray, rayHit);
 
-    rtcRay.tnear = 1e-3f;
-    rtcRay.tfar = maxT - 1e-3f;
+    CustomRTCIntersectContext context;
+    InitCustomRTCIntersectContext(&context, false);
 
-    rtcRay.flags = 0;
+    rtcIntersect1(
+        g_rtcScene,
+        &context.context,
+        &rayHit
+    );
+
+    return IntersectionResult({
+        buildIntersection(ray, rayHit, false),
+        context.volumeEvents
+    });
+}
+
+bool Scene::testOcclusion(const Ray &ray, float maxT) const
+{
+    RenderStats::local().shadowRays += 1;
+
+    // Plain shadow rays pass through boundaries, so pure boundary geometry
+    // is masked out of traversal entirely
+    RTCRay rtcRay;
+    initRay(ray, maxT, RTCMask::Surfaces, rtcRay);
 
     CustomRTCIntersectContext context;
     InitCustomRTCIntersectContext(&context, false);
@@ -380,21 +447,45 @@ bool Scene::testOcclusion(const Ray &ray, float maxT) const
     return std::isinf(rtcRay.tfar);
 }
 
-OcclusionResult Scene::testVolumetricOcclusion(const Ray &ray, float maxT) const
-{
-    RTCRay rtcRay;
-    rtcRay.org_x = ray.origin().x();
-    rtcRay.org_y = ray.origin().y();
-    rtcRay.org_z = ray.origin().z();
+void Scene::testOcclusion(
+    const Ray *rays,
+    const float *maxTs,
+    int count,
+    uint8_t *occluded
+) const {
+    RenderStats::local().shadowRays += count;
 
-    rtcRay.dir_x = ray.direction().x();
-    rtcRay.dir_y = ray.direction().y();
-    rtcRay.dir_z = ray.direction().z();
+    static thread_local std::vector<RTCRay> rtcRays;
+    rtcRays.resize(count);
 
-    rtcRay.tnear = 1e-3f;
-    rtcRay.tfar = maxT - 1e-3f;
+    for (int i = 0; i < count; i++) {
+        initRay(rays[i], maxTs[i], RTCMask::Surfaces, rtcRays[i]);
+    }
 
-    rtcRay.flags = 0;
+    // Passthrough events from geometry mixing boundaries and surfaces land
+    // in this one context, they're unused for plain occlusion
+    CustomRTCIntersectContext context;
+    InitCustomRTCIntersectContext(&context, false);
+
+    rtcOccluded1M(
+        g_rtcScene,
+        &context.context,
+        rtcRays.data(),
+        count,
+        sizeof(RTCRay)
+    );
+
+    for (int i = 0; i < count; i++) {
+        occluded[i] = std::isinf(rtcRays[i].tfar);
+    }
+}
+
+OcclusionResult Scene::testVolumetricOcclusion(const Ray &ray, float maxT) const
+{
+    RenderStats::local().volumetricOcclusionRays += 1;
+
+    RTCRay rtcRay;
+    initRay(ray, maxT, RTCMask::All, rtcRay);
 
     CustomRTCIntersectContext context;
     InitCustomRTCIntersectContext(&context, false);
@@ -409,14 +500,6 @@ OcclusionResult Scene::testVolumetricOcclusion(const Ray &ray, float maxT) const
         return OcclusionResult({ true });
     }
 
-    std::sort(
-        context.volumeEvents.begin(),
-        context.volumeEvents.end(),
-        [](VolumeEvent ve1, VolumeEvent ve2) {
-            return ve1.t < ve2.t;
-        }
-    );
-
     return OcclusionResult({
         false,
         context.volumeEvents
@@ -425,6 +508,8 @@ OcclusionResult Scene::testVolumetricOcclusion(const Ray &ray, float maxT) const
 
 LightSample Scene::sampleLights(RandomGenerator &random) const
 {
+    RenderStats::local().lightSamples += 1;
+
     const int lightCount = m_lights.size();
     const int lightIndex = (int)floorf(random.next() * lightCount);
 
@@ -448,6 +533,8 @@ LightSample Scene::sampleDirectLights(
     RandomGenerator &random
 ) const
 {
+    RenderStats::local().lightSamples += 1;
+
     const int lightCount = m_lights.size();
     const int lightIndex = (int)floorf(random.next() * lightCount);
 
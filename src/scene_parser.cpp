@@ -34,6 +34,7 @@
 #include "sphere.h"
 #include "surface.h"
 #include "texture.h"
+#include "trace.h"
 #include "transform.h"
 #include "types.h"
 #include "uv.h"
@@ -139,8 +140,14 @@ static void parseEnvironmentLight(
 
 Scene parseScene(std::ifstream &sceneFile)
 {
+    Trace::Scope sceneScope("parseScene");
+
     std::cout << "Parsing json scene..." << std::endl;
-    json sceneJson = json::parse(sceneFile);
+    json sceneJson;
+    {
+        Trace::Scope parseScope("json::parse");
+        sceneJson = json::parse(sceneFile);
+    }
     std::cout << "Done!" << std::endl;
 
     auto &sensor = sceneJson["sensor"];
@@ -245,6 +252,8 @@ static void parseInstance(
         rtcManager
     );
     instanceLookup[parseString(instanceJson["name"])] = rtcInstanceScene;
+
+    Trace::Scope commitScope("rtcCommitScene", parseString(instanceJson["name"]));
     rtcCommitScene(rtcInstanceScene);
 }
 
@@ -259,6 +268,11 @@ static void parseObjects(
     for (auto &objectJson : objectsJson) {
         if (parseBool(objectJson["skip"], false)) { continue; }
 
+        Trace::Scope objectScope(
+            "parse " + objectJson.value("type", std::string("model")),
+            objectJson.value("filename", objectJson.value("name", std::string()))
+        );
+
         bool needsRegistration = true;
 
         std::vector<std::shared_ptr<Surface>> localSurfaces;
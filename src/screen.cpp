@@ -205,7 +205,7 @@ PathedScreen::PathedScreen(
     auto clickCallback = [=, &scene](int x, int y) {
         std::cout << "clicked x: " << x << " y: " << y << std::endl;
 
-        integrator->helloWorld();
+        integrator->captureSamples((m_height - y - 1) * m_width + x);
 
         if (false) {
             const int rows = 400;
@@ -304,10 +304,16 @@ PathedScreen::PathedScreen(
 
 const Sample& PathedScreen::lookupSample(int currentSample, int renderX, int renderY)
 {
+    // Pixels are only captured from the pass after they were clicked
+    static const Sample uncaptured;
+
     const int lookupY = m_height - renderY - 1;
     const auto &sampleLookup = *m_sampleLookups[currentSample];
-    const Sample &sample = sampleLookup[lookupY * m_width + renderX];
-    return sample;
+
+    auto iter = sampleLookup.find(lookupY * m_width + renderX);
+    if (iter == sampleLookup.end()) { return uncaptured; }
+
+    return iter->second;
 }
 
 void PathedScreen::setPathVisualization()
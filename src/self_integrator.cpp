@@ -31,7 +31,7 @@ SelfIntegrator::SelfIntegrator(BounceController bounceController)
 
 void SelfIntegrator::preprocess(const Scene &scene, RandomGenerator &random)
 {
-    Ray ray = scene.getCamera()->generateRay(184, 97);
+    Ray ray = scene.getCamera()->generateRay(184, 97, random);
 
     Intersection intersection = scene.testIntersect(ray);
 
@@ -85,7 +85,7 @@ void SelfIntegrator::renderPDF(
             float z = sinf(theta) * sinf(phi);
 
             Vector3 wiHemisphere(x, y, z);
-            Vector3 wiWorld = intersection.tangentToWorld.apply(wiHemisphere);
+            Vector3 wiWorld = intersection.frame().toWorld(wiHemisphere);
 
             Ray ray = Ray(intersection.point, wiWorld);
             const Intersection fisheyeIntersection = scene.testIntersect(ray);
@@ -0,0 +1,44 @@
+#include "shading_frame.h"
+
+#include <cmath>
+
+ShadingFrame::ShadingFrame()
+    : m_xAxis(0.f),
+      m_normal(0.f),
+      m_zAxis(0.f)
+{}
+
+ShadingFrame::ShadingFrame(const Vector3 &normal, const Vector3 &woWorld)
+    : m_xAxis(0.f),
+      m_normal(normal),
+      m_zAxis(0.f)
+{
+    if (normal == woWorld) {
+        if (fabsf(normal.x()) > fabsf(normal.y())) {
+            m_xAxis = Vector3(-normal.z(), 0.f, normal.x()).normalized();
+        } else {
+            m_xAxis = Vector3(0.f, -normal.z(), normal.y()).normalized();
+        }
+        m_zAxis = normal.cross(m_xAxis);
+    } else {
+        m_xAxis = normal.cross(woWorld).normalized();
+        m_zAxis = normal.cross(m_xAxis).normalized();
+    }
+}
+
+Transform ShadingFrame::toWorldTransform() const
+{
+    float matrix[4][4] {
+        { m_xAxis.x(), m_normal.x(), m_zAxis.x(), 0.f },
+        { m_xAxis.y(), m_normal.y(), m_zAxis.y(), 0.f },
+        { m_xAxis.z(), m_normal.z(), m_zAxis.z(), 0.f },
+        { 0.f, 0.f, 0.f, 1.f }
+    };
+
+    return Transform(matrix);
+}
+
+Transform ShadingFrame::toLocalTransform() const
+{
+    return toWorldTransform().transposed();
+}
@@ -0,0 +1,46 @@
+#include "shadow_queue.h"
+
+#include "scene.h"
+
+#include <algorithm>
+
+// Rays per rtcOccluded1M call
+static const int StreamChunkSize = 256;
+
+ShadowQueue::ShadowQueue()
+    : m_owner(0)
+{}
+
+void ShadowQueue::push(const Ray &ray, float maxT, const Color &contribution)
+{
+    m_owners.push_back(m_owner);
+    m_rays.push_back(ray);
+    m_maxTs.push_back(maxT);
+    m_contributions.push_back(contribution);
+}
+
+void ShadowQueue::resolve(const Scene &scene, std::vector<Color> &results)
+{
+    const int count = m_rays.size();
+    m_occluded.resize(count);
+
+    for (int begin = 0; begin < count; begin += StreamChunkSize) {
+        scene.testOcclusion(
+            &m_rays[begin],
+            &m_maxTs[begin],
+            std::min(StreamChunkSize, count - begin),
+            &m_occluded[begin]
+        );
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (!m_occluded[i]) {
+            results[m_owners[i]] += m_contributions[i];
+        }
+    }
+
+    m_owners.clear();
+    m_rays.clear();
+    m_maxTs.clear();
+    m_contributions.clear();
+}
@@ -0,0 +1,30 @@
+#include "sobol_sampler.h"
+
+#include "low_discrepancy.h"
+
+SobolSampler::SobolSampler(uint64_t seed)
+    : Sampler(seed),
+      m_pixelSeed(0)
+{}
+
+void SobolSampler::startPixelSample(int pixelIndex, int sampleIndex)
+{
+    Sampler::startPixelSample(pixelIndex, sampleIndex);
+
+    m_pixelSeed = LowDiscrepancy::hashCombine(
+        LowDiscrepancy::hash(m_seed ^ (m_seed >> 32)),
+        pixelIndex
+    );
+}
+
+float SobolSampler::next()
+{
+    const uint32_t seed = LowDiscrepancy::hashCombine(m_pixelSeed, m_dimension++);
+    return LowDiscrepancy::sobol1D(m_sampleIndex, seed);
+}
+
+std::array<float, 2> SobolSampler::next2D()
+{
+    const uint32_t seed = LowDiscrepancy::hashCombine(m_pixelSeed, m_dimension++);
+    return LowDiscrepancy::sobol2D(m_sampleIndex, seed);
+}
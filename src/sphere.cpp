@@ -54,9 +54,10 @@ Sphere::Sphere(Point3 center, float radius)
 SurfaceSample Sphere::sample(RandomGenerator &random) const
 {
     // from pbrt
-    float z = 1 - 2 * random.next();
+    const std::array<float, 2> xi = random.next2D();
+    float z = 1 - 2 * xi[0];
     float r = sqrt(fmaxf(0, 1 - z * z));
-    float phi = 2 * M_PI * random.next();
+    float phi = 2 * M_PI * xi[1];
     Vector3 v(r * cosf(phi), r * sinf(phi), z);
 
     SurfaceSample sample = {
@@ -92,9 +93,10 @@ SurfaceSample Sphere::sample(
 
     // linearly interpolate between [cosThetaMax, 1];
     // theta will be between [0, cosThetaMax]
-    const float xi1 = random.next();
+    const std::array<float, 2> xi = random.next2D();
+    const float xi1 = xi[0];
     const float cosTheta = (1.f - xi1) + xi1 * cosThetaMax;
-    const float phi = random.next() * 2.f * M_PI;
+    const float phi = xi[1] * 2.f * M_PI;
 
     // compute distance to sample point on sphere
     const float sinTheta = Trig::sinFromCos(cosTheta);
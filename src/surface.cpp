@@ -40,16 +40,6 @@ float Surface::pdf(const Point3 &point, const Point3 &referencePoint, Measure me
     return m_shape->pdf(point, referencePoint, measure);
 }
 
-std::shared_ptr<Shape> Surface::getShape() const
-{
-    return m_shape;
-}
-
-std::shared_ptr<Material> Surface::getMaterial() const
-{
-    return m_material;
-}
-
 Color Surface::getRadiance() const
 {
     return m_material->emit();
@@ -0,0 +1,167 @@
+#include "tile_scheduler.h"
+
+#include <algorithm>
+#include <assert.h>
+
+static uint32_t spreadBits(uint32_t x)
+{
+    x &= 0x0000ffff;
+    x = (x | (x << 8)) & 0x00ff00ff;
+    x = (x | (x << 4)) & 0x0f0f0f0f;
+    x = (x | (x << 2)) & 0x33333333;
+    x = (x | (x << 1)) & 0x55555555;
+    return x;
+}
+
+static uint32_t mortonCode(uint32_t x, uint32_t y)
+{
+    return spreadBits(x) | (spreadBits(y) << 1);
+}
+
+static uint64_t packRange(uint32_t begin, uint32_t end)
+{
+    return (uint64_t(end) << 32) | begin;
+}
+
+static uint32_t rangeBegin(uint64_t range) { return range & 0xffffffff; }
+static uint32_t rangeEnd(uint64_t range) { return range >> 32; }
+
+TileScheduler::TileScheduler(int width, int height, int tileSize)
+    : TileScheduler(Tile({ 0, height, 0, width }), tileSize)
+{}
+
+TileScheduler::TileScheduler(const Tile &region, int tileSize)
+{
+    assert(tileSize > 0);
+
+    const int width = region.endCol - region.startCol;
+    const int height = region.endRow - region.startRow;
+
+    const int tileCols = (width + tileSize - 1) / tileSize;
+    const int tileRows = (height + tileSize - 1) / tileSize;
+
+    std::vector<std::pair<uint32_t, Tile> > codedTiles;
+    for (int tileRow = 0; tileRow < tileRows; tileRow++) {
+        for (int tileCol = 0; tileCol < tileCols; tileCol++) {
+            Tile tile = {
+                region.startRow + tileRow * tileSize,
+                region.startRow + std::min(height, (tileRow + 1) * tileSize),
+                region.startCol + tileCol * tileSize,
+                region.startCol + std::min(width, (tileCol + 1) * tileSize)
+            };
+            codedTiles.push_back({ mortonCode(tileCol, tileRow), tile });
+        }
+    }
+
+    std::sort(
+        codedTiles.begin(),
+        codedTiles.end(),
+        [](const std::pair<uint32_t, Tile> &a, const std::pair<uint32_t, Tile> &b) {
+            return a.first < b.first;
+        }
+    );
+
+    for (const auto &codedTile : codedTiles) {
+        m_tiles.push_back(codedTile.second);
+    }
+    m_tileSeconds.resize(m_tiles.size(), 0.0);
+}
+
+void TileScheduler::reset(int workerCount)
+{
+    assert(workerCount > 0);
+
+    m_workers = std::vector<WorkerState>(workerCount);
+
+    const int tileCount = m_tiles.size();
+    for (int i = 0; i < workerCount; i++) {
+        const uint32_t begin = (uint64_t)tileCount * i / workerCount;
+        const uint32_t end = (uint64_t)tileCount * (i + 1) / workerCount;
+
+        m_workers[i].range.store(packRange(begin, end));
+        m_workers[i].stealCount = 0;
+        m_workers[i].busySeconds = 0.0;
+    }
+
+    std::fill(m_tileSeconds.begin(), m_tileSeconds.end(), 0.0);
+}
+
+bool TileScheduler::next(int workerID, int *tileIndex)
+{
+    std::atomic<uint64_t> &range = m_workers[workerID].range;
+
+    uint64_t current = range.load();
+    while (rangeBegin(current) < rangeEnd(current)) {
+        const uint64_t updated = packRange(rangeBegin(current) + 1, rangeEnd(current));
+        if (range.compare_exchange_weak(current, updated)) {
+            *tileIndex = rangeBegin(current);
+            return true;
+        }
+    }
+
+    return steal(workerID, tileIndex);
+}
+
+bool TileScheduler::steal(int workerID, int *tileIndex)
+{
+    const int workerCount = m_workers.size();
+
+    while (true) {
+        int victimID = -1;
+        uint32_t mostRemaining = 0;
+        for (int i = 1; i < workerCount; i++) {
+            const int candidateID = (workerID + i) % workerCount;
+            const uint64_t range = m_workers[candidateID].range.load();
+            const uint32_t remaining = rangeEnd(range) - rangeBegin(range);
+            if (rangeBegin(range) < rangeEnd(range) && remaining > mostRemaining) {
+                victimID = candidateID;
+                mostRemaining = remaining;
+            }
+        }
+
+        if (victimID == -1) { return false; }
+
+        std::atomic<uint64_t> &range = m_workers[victimID].range;
+        uint64_t current = range.load();
+        while (rangeBegin(current) < rangeEnd(current)) {
+            const uint64_t updated = packRange(rangeBegin(current), rangeEnd(current) - 1);
+            if (range.compare_exchange_weak(current, updated)) {
+                *tileIndex = rangeEnd(current) - 1;
+                m_workers[workerID].stealCount += 1;
+                return true;
+            }
+        }
+        // Victim drained while we were picking it, look again
+    }
+}
+
+void TileScheduler::recordTime(int workerID, int tileIndex, double seconds)
+{
+    m_tileSeconds[tileIndex] = seconds;
+    m_workers[workerID].busySeconds += seconds;
+}
+
+TileStats TileScheduler::stats() const
+{
+    TileStats stats = {};
+    stats.tileCount = m_tiles.size();
+
+    for (double seconds : m_tileSeconds) {
+        stats.meanTileSeconds += seconds;
+        stats.maxTileSeconds = std::max(stats.maxTileSeconds, seconds);
+    }
+    if (stats.tileCount > 0) {
+        stats.meanTileSeconds /= stats.tileCount;
+    }
+
+    for (const WorkerState &worker : m_workers) {
+        stats.stealCount += worker.stealCount;
+        stats.meanWorkerSeconds += worker.busySeconds;
+        stats.maxWorkerSeconds = std::max(stats.maxWorkerSeconds, worker.busySeconds);
+    }
+    if (!m_workers.empty()) {
+        stats.meanWorkerSeconds /= m_workers.size();
+    }
+
+    return stats;
+}
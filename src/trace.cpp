@@ -0,0 +1,91 @@
+#include "trace.h"
+
+#include "json.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <unistd.h>
+#include <vector>
+
+using json = nlohmann::json;
+
+struct TraceEvent {
+    std::string name;
+    std::string detail;
+    int64_t beginMicros;
+    int64_t durationMicros;
+    int threadID;
+};
+
+static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+static std::mutex eventsLock;
+static std::vector<TraceEvent> events;
+
+static int64_t microsSinceEpoch(std::chrono::steady_clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(time - epoch).count();
+}
+
+// Small, stable IDs read better in the viewer than hashed std::thread::ids
+static int currentThreadID()
+{
+    static std::atomic<int> nextThreadID(0);
+    static thread_local int threadID = nextThreadID++;
+    return threadID;
+}
+
+Trace::Scope::Scope(const std::string &name)
+    : Scope(name, "")
+{}
+
+Trace::Scope::Scope(const std::string &name, const std::string &detail)
+    : m_name(name),
+      m_detail(detail),
+      m_begin(std::chrono::steady_clock::now())
+{}
+
+Trace::Scope::~Scope()
+{
+    const auto end = std::chrono::steady_clock::now();
+
+    TraceEvent event = {
+        m_name,
+        m_detail,
+        microsSinceEpoch(m_begin),
+        microsSinceEpoch(end) - microsSinceEpoch(m_begin),
+        currentThreadID()
+    };
+
+    std::lock_guard<std::mutex> guard(eventsLock);
+    events.push_back(event);
+}
+
+void Trace::write(const std::string &path)
+{
+    json traceEvents = json::array();
+    {
+        std::lock_guard<std::mutex> guard(eventsLock);
+
+        for (const TraceEvent &event : events) {
+            json eventJson = {
+                { "name", event.name },
+                { "ph", "X" },
+                { "ts", event.beginMicros },
+                { "dur", event.durationMicros },
+                { "pid", getpid() },
+                { "tid", event.threadID },
+            };
+            if (!event.detail.empty()) {
+                eventJson["args"] = { { "detail", event.detail } };
+            }
+
+            traceEvents.push_back(eventJson);
+        }
+    }
+
+    std::ofstream traceFile(path);
+    traceFile << json({ { "traceEvents", traceEvents } }) << std::endl;
+}
@@ -15,8 +15,9 @@ Triangle::Triangle(Point3 p0, Point3 p1, Point3 p2)
 
 SurfaceSample Triangle::sample(RandomGenerator &random) const
 {
-    float r1 = random.next();
-    float r2 = random.next();
+    const std::array<float, 2> xi = random.next2D();
+    float r1 = xi[0];
+    float r2 = xi[1];
 
     float a = 1 - sqrt(r1);
     float b = sqrt(r1) * (1 - r2);
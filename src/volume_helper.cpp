@@ -8,6 +8,7 @@
 #include "scene.h"
 
 #include <assert.h>
+#include <cmath>
 
 Color VolumeHelper::directSampleLights(
     const Medium &medium,
@@ -37,7 +38,7 @@ Color VolumeHelper::directSampleLights(
         // TODO: Over all intersected volumes
         Color shadowTransmittance(0.f);
 
-        const std::vector<VolumeEvent> &volumeEvents = occlusionResult.volumeEvents;
+        const VolumeEventList &volumeEvents = occlusionResult.volumeEvents;
         const size_t eventCount = volumeEvents.size();
         if (eventCount > 0) {
             assert(eventCount == 1 || eventCount == 2);
@@ -70,7 +71,7 @@ Color VolumeHelper::directSampleLights(
 
 Color VolumeHelper::rayTransmission(
     const Ray &ray,
-    const std::vector<VolumeEvent> &volumeEvents,
+    const VolumeEventList &volumeEvents,
     const std::shared_ptr<Medium> &mediumPtr
 ) {
     Color transmittance(1.f);
@@ -100,13 +101,13 @@ Color VolumeHelper::rayTransmission(
         } else {
             assert(eventCount == 1 || eventCount == 2);
 
-            const std::shared_ptr<Medium> mediumPtr = volumeEvents[0].mediumPtr;
+            const Medium *medium = volumeEvents[0].medium;
 
             if (eventCount == 2) {
                 const Point3 enterPoint = ray.at(volumeEvents[0].t);
                 const Point3 exitPoint = ray.at(volumeEvents[1].t);
 
-                transmittance *= mediumPtr->transmittance(enterPoint, exitPoint);
+                transmittance *= medium->transmittance(enterPoint, exitPoint);
             } else if (eventCount == 1) {
                 // TODO: Remove tnear in embree, and remove this code!
                 // If there's only one event, assume the volume was too close to
@@ -114,7 +115,7 @@ Color VolumeHelper::rayTransmission(
                 const Point3 enterPoint = ray.origin();
                 const Point3 exitPoint = ray.at(volumeEvents[0].t);
 
-                transmittance *= mediumPtr->transmittance(enterPoint, exitPoint);
+                transmittance *= medium->transmittance(enterPoint, exitPoint);
             }
         }
     }
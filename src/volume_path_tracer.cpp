@@ -3,14 +3,22 @@
 #include "bounce_controller.h"
 #include "color.h"
 #include "direct_lighting_helper.h"
+#include "globals.h"
+#include "job.h"
 #include "monte_carlo.h"
 #include "ray.h"
 #include "transform.h"
 #include "vector.h"
 
 #include <iostream>
+#include <vector>
 
 
+VolumePathTracer::VolumePathTracer(BounceController bounceController)
+    : m_bounceController(bounceController),
+      m_russianRoulette(g_job->russianRoulette())
+{}
+
 Color VolumePathTracer::L(
     const Intersection &intersection,
     const Scene &scene,
@@ -18,22 +26,44 @@ Color VolumePathTracer::L(
     int pixelIndex,
     Sample &sample
 ) const {
-    std::shared_ptr<Medium> mediumPtr(nullptr);
+    sample.recordEyePoint(intersection.point);
 
-    sample.eyePoints.push_back(intersection.point);
+    Color result(0.f);
 
-    BSDFSample bsdfSample = intersection.material->sample(intersection, random);
+    // Split copies wait here until the path that spawned them is finished
+    std::vector<PathVertex> pending = { { intersection, nullptr, Color(1.f), 1, 1.f } };
+    while (!pending.empty()) {
+        const PathVertex vertex = pending.back();
+        pending.pop_back();
 
-    Color result(0.f);
-    if (m_bounceController.checkCounts(1)) {
-        result = DirectLightingHelper::Ld(intersection, mediumPtr, bsdfSample, scene, random, sample);
-        sample.contributions.push_back({result, 1.f});
+        result += extendPath(vertex, scene, random, sample, pending);
     }
 
-    Color modulation = Color(1.f);
-    Intersection lastIntersection = intersection;
+    return result;
+}
+
+Color VolumePathTracer::extendPath(
+    const PathVertex &vertex,
+    const Scene &scene,
+    RandomGenerator &random,
+    Sample &sample,
+    std::vector<PathVertex> &pending
+) const {
+    std::shared_ptr<Medium> mediumPtr = vertex.mediumPtr;
+    Color modulation = vertex.modulation;
+    Intersection lastIntersection = vertex.intersection;
+
+    BSDFSample bsdfSample = lastIntersection.material->sample(lastIntersection, random);
+
+    Color result(0.f);
+    if (m_bounceController.checkCounts(vertex.bounce)) {
+        Color Ld = DirectLightingHelper::Ld(lastIntersection, mediumPtr, bsdfSample, scene, random, sample);
+        result += Ld * modulation;
+
+        sample.recordContribution({result, vertex.invPDF});
+    }
 
-    for (int bounce = 2; !m_bounceController.checkDone(bounce); bounce++) {
+    for (int bounce = vertex.bounce + 1; !m_bounceController.checkDone(bounce); bounce++) {
         Ray bounceRay(lastIntersection.point, bsdfSample.wiWorld);
 
         // Refraction, medium changes
@@ -49,7 +79,7 @@ Color VolumePathTracer::L(
         Intersection bounceIntersection = scene.testIntersect(bounceRay);
         if (!bounceIntersection.hit) { break; }
 
-        sample.eyePoints.push_back(bounceIntersection.point);
+        sample.recordEyePoint(bounceIntersection.point);
 
         const float invPDF = 1.f / bsdfSample.pdf;
         const float cosTheta = WorldFrame::absCosTheta(lastIntersection.shadingNormal, bsdfSample.wiWorld);
@@ -72,6 +102,18 @@ Color VolumePathTracer::L(
             break;
         }
 
+        // Same as PathTracer: no roulette before the first counted bounce
+        if (bounce >= m_bounceController.startBounce()) {
+            float weight;
+            const int copies = m_russianRoulette.evaluate(bounce, modulation, random, &weight);
+            if (copies == 0) { break; }
+
+            modulation *= weight;
+            for (int copy = 1; copy < copies; copy++) {
+                pending.push_back({ bounceIntersection, mediumPtr, modulation, bounce, invPDF });
+            }
+        }
+
         bsdfSample = bounceIntersection.material->sample(
             bounceIntersection, random
         );
@@ -91,7 +133,7 @@ Color VolumePathTracer::L(
             );
             result += Ld * modulation;
 
-            sample.contributions.push_back({result - previous, invPDF});
+            sample.recordContribution({result - previous, invPDF});
         }
     }
 
@@ -0,0 +1,474 @@
+#include "wavefront_integrator.h"
+
+#include "camera.h"
+#include "globals.h"
+#include "job.h"
+#include "light.h"
+#include "measure.h"
+#include "mis.h"
+#include "render_stats.h"
+#include "sampler.h"
+#include "tile_scheduler.h"
+#include "volume_helper.h"
+#include "world_frame.h"
+
+#include "omp.h"
+
+#include <algorithm>
+#include <functional>
+
+// Rays per rtc*1M call; small enough to spread a wave's tail across threads
+static const int StreamChunkSize = 256;
+
+static const Ray EmptyRay(Point3(0.f, 0.f, 0.f), Vector3(0.f));
+
+void WavefrontIntegrator::PathStates::resize(int count)
+{
+    pixelIndex.resize(count);
+    sampleIndex.resize(count);
+    dimension.resize(count);
+    bounce.resize(count);
+    segments.resize(count);
+    radiance.resize(count, Color(0.f));
+    modulation.resize(count, Color(1.f));
+    intersection.resize(count, IntersectionHelper::miss);
+    bsdfSample.resize(count, BSDFSample({ Vector3(0.f), 0.f, Color(0.f), nullptr }));
+}
+
+void WavefrontIntegrator::ShadowQueue::clear()
+{
+    path.clear();
+    rays.clear();
+    maxTs.clear();
+    contributions.clear();
+    occluded.clear();
+}
+
+void WavefrontIntegrator::sampleImage(
+    Accumulator &accumulator,
+    SampleLookup &sampleLookup,
+    Scene &scene,
+    RandomGenerator &random,
+    int sampleIndex
+) {
+    const int width = g_job->width();
+
+    m_waveSize = g_job->wavefrontSize();
+
+    m_samplers.clear();
+    for (int i = 0; i < omp_get_max_threads(); i++) {
+        m_samplers.push_back(g_job->sampler());
+    }
+
+    // Morton tile order keeps each wave's camera rays spatially coherent
+    TileScheduler scheduler(g_job->cropWindow(), g_job->tileSize());
+
+    std::vector<int> pixelIndices;
+    for (int tileIndex = 0; tileIndex < scheduler.tileCount(); tileIndex++) {
+        const Tile &tile = scheduler.tile(tileIndex);
+        for (int row = tile.startRow; row < tile.endRow; row++) {
+            for (int col = tile.startCol; col < tile.endCol; col++) {
+                const int pixelIndex = row * width + col;
+                if (accumulator.isActive(pixelIndex)) {
+                    pixelIndices.push_back(pixelIndex);
+                }
+            }
+        }
+    }
+
+    for (size_t begin = 0; begin < pixelIndices.size(); begin += m_waveSize) {
+        const size_t end = std::min(pixelIndices.size(), begin + m_waveSize);
+        traceWave(
+            std::vector<int>(pixelIndices.begin() + begin, pixelIndices.begin() + end),
+            accumulator,
+            scene
+        );
+    }
+}
+
+void WavefrontIntegrator::traceWave(
+    const std::vector<int> &pixelIndices,
+    Accumulator &accumulator,
+    const Scene &scene
+) {
+    const int pathCount = pixelIndices.size();
+
+    m_paths.resize(pathCount);
+    m_active.resize(pathCount);
+    for (int path = 0; path < pathCount; path++) {
+        m_paths.pixelIndex[path] = pixelIndices[path];
+        m_paths.sampleIndex[path] = accumulator.sampleCount(pixelIndices[path]);
+        m_paths.dimension[path] = 0;
+        m_paths.bounce[path] = 0;
+        m_paths.segments[path] = 1;
+        m_paths.radiance[path] = Color(0.f);
+        m_paths.modulation[path] = Color(1.f);
+
+        m_active[path] = path;
+    }
+
+    generateCameraRays(g_job->width(), scene);
+    traceIntersections(scene, true);
+
+    // Every path is still active here, so m_hits lines up with paths
+    if (AOVBuffer *aovs = aovBuffer()) {
+        for (int path = 0; path < pathCount; path++) {
+            aovs->add(m_paths.pixelIndex[path], m_hits[path]);
+        }
+    }
+
+    shadePrimary(scene);
+
+    while (!m_active.empty()) {
+        generateShadowRays(scene);
+        generateExtensionRays();
+
+        traceShadows(scene);
+        traceIntersections(scene, false);
+
+        shadeExtensions(scene);
+    }
+
+    RenderCounters &counters = RenderStats::local();
+    counters.primaryRays += pathCount;
+
+    for (int path = 0; path < pathCount; path++) {
+        accumulator.add(m_paths.pixelIndex[path], m_paths.radiance[path]);
+        counters.recordPathLength(m_paths.segments[path]);
+    }
+}
+
+void WavefrontIntegrator::generateCameraRays(int width, const Scene &scene)
+{
+    const int count = m_active.size();
+    m_rays.resize(count, EmptyRay);
+
+    #pragma omp parallel for
+    for (int i = 0; i < count; i++) {
+        const int path = m_active[i];
+        const int pixelIndex = m_paths.pixelIndex[path];
+
+        Sampler &sampler = *m_samplers[omp_get_thread_num()];
+        sampler.startPixelSample(pixelIndex, m_paths.sampleIndex[path]);
+
+        m_rays[i] = scene.getCamera()->generateRay(
+            pixelIndex / width,
+            pixelIndex % width,
+            sampler
+        );
+
+        m_paths.dimension[path] = sampler.dimension();
+    }
+}
+
+void WavefrontIntegrator::shadePrimary(const Scene &scene)
+{
+    const int count = m_active.size();
+    std::vector<uint8_t> alive(count, false);
+
+    #pragma omp parallel for
+    for (int i = 0; i < count; i++) {
+        const int path = m_active[i];
+        const Ray &ray = m_rays[i];
+        const Intersection &intersection = m_hits[i];
+
+        Color &radiance = m_paths.radiance[path];
+
+        if (!intersection.hit) {
+            radiance += scene.environmentL(ray.direction());
+            continue;
+        }
+
+        if (m_bounceController.checkCounts(0)) {
+            Color emit = intersection.material->emit();
+            if (!emit.isBlack() && !IntersectionHelper::checkBacksideIntersection(intersection)) {
+                radiance += emit;
+            }
+
+            if (intersection.material->isContainer()) {
+                const IntersectionResult volumetricResult = scene.testVolumetricIntersect(ray);
+                const Intersection &volumetricIntersection = volumetricResult.intersection;
+
+                const Color transmittance = VolumeHelper::rayTransmission(
+                    ray,
+                    volumetricResult.volumeEvents,
+                    nullptr
+                );
+
+                if (volumetricIntersection.hit) {
+                    radiance += volumetricIntersection.material->emit() * transmittance;
+                } else {
+                    radiance += scene.environmentL(ray.direction()) * transmittance;
+                }
+
+                m_paths.segments[path] += 1;
+            }
+        }
+
+        Sampler &sampler = *m_samplers[omp_get_thread_num()];
+        sampler.resumePixelSample(
+            m_paths.pixelIndex[path],
+            m_paths.sampleIndex[path],
+            m_paths.dimension[path]
+        );
+
+        m_paths.bsdfSample[path] = intersection.material->sample(intersection, sampler);
+        m_paths.intersection[path] = intersection;
+        m_paths.bounce[path] = 1;
+
+        m_paths.dimension[path] = sampler.dimension();
+
+        alive[i] = true;
+    }
+
+    int liveCount = 0;
+    for (int i = 0; i < count; i++) {
+        if (alive[i]) { m_active[liveCount++] = m_active[i]; }
+    }
+    m_active.resize(liveCount);
+}
+
+// Light sampling half of PathTracer::direct. The contribution is computed up
+// front and only lands in the path's radiance if the shadow ray is clear.
+void WavefrontIntegrator::generateShadowRays(const Scene &scene)
+{
+    const int count = m_active.size();
+
+    m_sampledMIS.resize(count);
+
+    std::vector<uint8_t> queued(count, false);
+    std::vector<Ray> rays(count, EmptyRay);
+    std::vector<float> maxTs(count);
+    std::vector<Color> contributions(count, Color(0.f));
+
+    #pragma omp parallel for
+    for (int i = 0; i < count; i++) {
+        const int path = m_active[i];
+        const Intersection &intersection = m_paths.intersection[path];
+        const BSDFSample &bsdfSample = m_paths.bsdfSample[path];
+
+        // Emitters skip direct lighting, same as PathTracer
+        m_sampledMIS[i] = m_bounceController.checkCounts(m_paths.bounce[path])
+            && !intersection.isEmitter();
+
+        if (!m_sampledMIS[i] || bsdfSample.material->isDelta()) { continue; }
+
+        Sampler &sampler = *m_samplers[omp_get_thread_num()];
+        sampler.resumePixelSample(
+            m_paths.pixelIndex[path],
+            m_paths.sampleIndex[path],
+            m_paths.dimension[path]
+        );
+
+        const LightSample lightSample = scene.sampleDirectLights(intersection.point, sampler);
+        m_paths.dimension[path] = sampler.dimension();
+
+        const Vector3 lightDirection = (lightSample.point - intersection.point).toVector();
+        const Vector3 wiWorld = lightDirection.normalized();
+
+        // Sample hit back of light
+        if (lightSample.normal.dot(wiWorld) >= 0.f) { continue; }
+
+        const float pdf = lightSample.solidAnglePDF(intersection.point);
+        const float brdfPDF = bsdfSample.material->pdf(intersection, wiWorld);
+        const float lightWeight = MIS::balanceWeight(1, 1, pdf, brdfPDF);
+
+        const Vector3 lightWo = -lightDirection.normalized();
+
+        queued[i] = true;
+        rays[i] = Ray(intersection.point, wiWorld);
+        maxTs[i] = lightDirection.length();
+        contributions[i] = m_paths.modulation[path]
+            * lightSample.light->emit(lightWo)
+            * lightWeight
+            * intersection.material->f(intersection, wiWorld)
+            * WorldFrame::absCosTheta(intersection.shadingNormal, wiWorld)
+            / pdf;
+    }
+
+    m_shadows.clear();
+    for (int i = 0; i < count; i++) {
+        if (!queued[i]) { continue; }
+
+        m_shadows.path.push_back(m_active[i]);
+        m_shadows.rays.push_back(rays[i]);
+        m_shadows.maxTs.push_back(maxTs[i]);
+        m_shadows.contributions.push_back(contributions[i]);
+    }
+    m_shadows.occluded.resize(m_shadows.path.size());
+}
+
+// One ray serves both as the BSDF half of direct lighting and as the next
+// path segment; paths needing neither are finished here
+void WavefrontIntegrator::generateExtensionRays()
+{
+    const int count = m_active.size();
+
+    int liveCount = 0;
+    for (int i = 0; i < count; i++) {
+        const int path = m_active[i];
+        const bool continues = !m_bounceController.checkDone(m_paths.bounce[path] + 1);
+
+        if (!m_sampledMIS[i] && !continues) { continue; }
+
+        m_active[liveCount] = path;
+        m_sampledMIS[liveCount] = m_sampledMIS[i];
+        liveCount += 1;
+    }
+    m_active.resize(liveCount);
+    m_sampledMIS.resize(liveCount);
+
+    m_rays.resize(liveCount, EmptyRay);
+    for (int i = 0; i < liveCount; i++) {
+        const int path = m_active[i];
+
+        m_rays[i] = Ray(
+            m_paths.intersection[path].point,
+            m_paths.bsdfSample[path].wiWorld
+        );
+        m_paths.segments[path] += 1;
+    }
+}
+
+void WavefrontIntegrator::shadeExtensions(const Scene &scene)
+{
+    const int count = m_active.size();
+
+    // Group hits by material so that neighbouring iterations run the same
+    // sample() code over the same textures
+    std::vector<int> shadingOrder(count);
+    for (int i = 0; i < count; i++) {
+        shadingOrder[i] = i;
+    }
+    std::sort(
+        shadingOrder.begin(),
+        shadingOrder.end(),
+        [this](int a, int b) {
+            return std::less<const Material *>()(m_hits[a].material, m_hits[b].material);
+        }
+    );
+
+    std::vector<uint8_t> alive(count, false);
+
+    #pragma omp parallel for schedule(static)
+    for (int orderIndex = 0; orderIndex < count; orderIndex++) {
+        const int i = shadingOrder[orderIndex];
+        const int path = m_active[i];
+
+        const Intersection &lastIntersection = m_paths.intersection[path];
+        const Intersection &bounceIntersection = m_hits[i];
+        const BSDFSample &bsdfSample = m_paths.bsdfSample[path];
+
+        Color &modulation = m_paths.modulation[path];
+
+        const float cosTheta = WorldFrame::absCosTheta(
+            lastIntersection.shadingNormal,
+            bsdfSample.wiWorld
+        );
+
+        // BSDF half of PathTracer::direct
+        if (m_sampledMIS[i]) {
+            Color emit(0.f);
+            float lightPDF = 0.f;
+
+            if (bounceIntersection.hit && bounceIntersection.isEmitter()
+                && bounceIntersection.woWorld.dot(bounceIntersection.shadingNormal) >= 0.f
+            ) {
+                emit = bounceIntersection.material->emit();
+                lightPDF = scene.lightsPDF(
+                    lastIntersection.point,
+                    bounceIntersection,
+                    Measure::SolidAngle
+                );
+            } else if (!bounceIntersection.hit) {
+                emit = scene.environmentL(bsdfSample.wiWorld);
+                if (!emit.isBlack()) {
+                    lightPDF = scene.environmentPDF(bsdfSample.wiWorld, Measure::SolidAngle);
+                }
+            }
+
+            if (!emit.isBlack()) {
+                const float brdfWeight = bsdfSample.material->isDelta()
+                    ? 1.f
+                    : MIS::balanceWeight(1, 1, bsdfSample.pdf, lightPDF);
+
+                m_paths.radiance[path] += modulation
+                    * emit
+                    * brdfWeight
+                    * bsdfSample.throughput
+                    * cosTheta
+                    / bsdfSample.pdf;
+            }
+        }
+
+        const int bounce = m_paths.bounce[path] + 1;
+        if (!bounceIntersection.hit || m_bounceController.checkDone(bounce)) { continue; }
+
+        modulation *= bsdfSample.throughput
+            * cosTheta
+            * (1.f / bsdfSample.pdf);
+
+        if (modulation.isBlack()) { continue; }
+
+        Sampler &sampler = *m_samplers[omp_get_thread_num()];
+        sampler.resumePixelSample(
+            m_paths.pixelIndex[path],
+            m_paths.sampleIndex[path],
+            m_paths.dimension[path]
+        );
+
+        m_paths.bsdfSample[path] = bounceIntersection.material->sample(
+            bounceIntersection, sampler
+        );
+        m_paths.intersection[path] = bounceIntersection;
+        m_paths.bounce[path] = bounce;
+
+        m_paths.dimension[path] = sampler.dimension();
+
+        alive[i] = true;
+    }
+
+    int liveCount = 0;
+    for (int i = 0; i < count; i++) {
+        if (alive[i]) { m_active[liveCount++] = m_active[i]; }
+    }
+    m_active.resize(liveCount);
+}
+
+void WavefrontIntegrator::traceIntersections(const Scene &scene, bool coherent)
+{
+    const int count = m_rays.size();
+    m_hits.resize(count, IntersectionHelper::miss);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int begin = 0; begin < count; begin += StreamChunkSize) {
+        const int chunkCount = std::min(StreamChunkSize, count - begin);
+
+        if (coherent && g_job->packetPrimaryRays()) {
+            scene.testIntersectPacket(&m_rays[begin], chunkCount, &m_hits[begin]);
+        } else {
+            scene.testIntersect(&m_rays[begin], chunkCount, &m_hits[begin]);
+        }
+    }
+}
+
+void WavefrontIntegrator::traceShadows(const Scene &scene)
+{
+    const int count = m_shadows.rays.size();
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int begin = 0; begin < count; begin += StreamChunkSize) {
+        scene.testOcclusion(
+            &m_shadows.rays[begin],
+            &m_shadows.maxTs[begin],
+            std::min(StreamChunkSize, count - begin),
+            &m_shadows.occluded[begin]
+        );
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (!m_shadows.occluded[i]) {
+            m_paths.radiance[m_shadows.path[i]] += m_shadows.contributions[i];
+        }
+    }
+}
@@ -0,0 +1,173 @@
+#include "work_queue.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+static const char *States[] = { "pending", "claimed", "done" };
+static const char *KeyName = "job";
+
+// How long claim() waits for a queue that another worker has moved aside
+static const int MissingQueueRetries = 100;
+static const int MissingQueueRetryMicroseconds = 10000;
+
+static std::vector<std::string> listDirectory(const std::string &directory)
+{
+    std::vector<std::string> names;
+
+    DIR *dir = opendir(directory.c_str());
+    if (dir == nullptr) { return names; }
+
+    while (struct dirent *entry = readdir(dir)) {
+        const std::string name = entry->d_name;
+        if (name != "." && name != "..") {
+            names.push_back(name);
+        }
+    }
+    closedir(dir);
+
+    return names;
+}
+
+static void removeTree(const std::string &directory)
+{
+    for (const char *state : States) {
+        const std::string stateDirectory = directory + "/" + state;
+        for (const std::string &name : listDirectory(stateDirectory)) {
+            unlink((stateDirectory + "/" + name).c_str());
+        }
+        rmdir(stateDirectory.c_str());
+    }
+    unlink((directory + "/" + KeyName).c_str());
+    rmdir(directory.c_str());
+}
+
+WorkQueue::WorkQueue(const std::string &directory)
+    : m_directory(directory)
+{}
+
+std::string WorkQueue::itemPath(const std::string &state, int item) const
+{
+    std::ostringstream pathStream;
+    pathStream << m_directory << "/" << state << "/"
+               << std::setfill('0') << std::setw(5) << item;
+    return pathStream.str();
+}
+
+bool WorkQueue::hasKey(const std::string &directory, uint64_t jobKey) const
+{
+    std::ifstream keyFile(directory + "/" + KeyName);
+
+    uint64_t key;
+    return (keyFile >> key) && key == jobKey;
+}
+
+bool WorkQueue::create(int itemCount, uint64_t jobKey, const std::string &workerName)
+{
+    struct stat info;
+    if (stat(m_directory.c_str(), &info) == 0) {
+        const std::string stale = m_directory + ".stale-" + workerName;
+
+        // Left over from a different job: move it aside before tearing it
+        // down so nobody joins it halfway through. The key is read right
+        // before the rename, in case another worker of this job has just
+        // rebuilt the queue.
+        if (hasKey(m_directory, jobKey)) { return true; }
+        if (rename(m_directory.c_str(), stale.c_str()) == 0) {
+            if (hasKey(stale, jobKey)) {
+                // Lost that race anyway, put the new queue back
+                if (rename(stale.c_str(), m_directory.c_str()) == 0) { return true; }
+            }
+            removeTree(stale);
+        } else if (errno != ENOENT) {
+            return false;
+        }
+    }
+
+    // Named per worker, not per process, since workers on different hosts
+    // of a shared filesystem can have the same pid
+    const std::string staging = m_directory + ".staging-" + workerName;
+
+    if (mkdir(staging.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH) != 0) { return false; }
+    for (const char *state : States) {
+        mkdir((staging + "/" + state).c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+    }
+
+    WorkQueue stagingQueue(staging);
+    for (int item = 0; item < itemCount; item++) {
+        std::ofstream itemFile(stagingQueue.itemPath("pending", item));
+    }
+
+    {
+        std::ofstream keyFile(staging + "/" + KeyName);
+        keyFile << jobKey << std::endl;
+    }
+
+    // Losing the race is fine, another worker's identical queue is in place
+    if (rename(staging.c_str(), m_directory.c_str()) != 0) {
+        removeTree(staging);
+        return stat(m_directory.c_str(), &info) == 0 && hasKey(m_directory, jobKey);
+    }
+
+    return true;
+}
+
+bool WorkQueue::claim(const std::string &workerName, int *item)
+{
+    const std::string pendingDirectory = m_directory + "/pending";
+
+    int missingCount = 0;
+    while (true) {
+        const std::vector<std::string> pending = listDirectory(pendingDirectory);
+        if (pending.empty()) {
+            // An empty pending/ means the queue is drained. A missing one
+            // means a worker is briefly holding it aside while replacing a
+            // stale queue, so wait for it to come back.
+            struct stat info;
+            if (stat(pendingDirectory.c_str(), &info) == 0) { return false; }
+            if (++missingCount > MissingQueueRetries) { return false; }
+
+            usleep(MissingQueueRetryMicroseconds);
+            continue;
+        }
+
+        for (const std::string &name : pending) {
+            const int candidate = atoi(name.c_str());
+            const std::string claimedPath = itemPath("claimed", candidate);
+
+            if (rename(itemPath("pending", candidate).c_str(), claimedPath.c_str()) == 0) {
+                // Only for people inspecting the queue
+                std::ofstream claimedFile(claimedPath);
+                claimedFile << workerName << std::endl;
+
+                *item = candidate;
+                return true;
+            }
+            // Someone else got there first, try the next one. Anything
+            // else is a broken queue that retrying won't fix.
+            if (errno != ENOENT) { return false; }
+        }
+    }
+}
+
+bool WorkQueue::complete(int item)
+{
+    return rename(itemPath("claimed", item).c_str(), itemPath("done", item).c_str()) == 0;
+}
+
+int WorkQueue::pendingCount() const
+{
+    return listDirectory(m_directory + "/pending").size();
+}
+
+int WorkQueue::doneCount() const
+{
+    return listDirectory(m_directory + "/done").size();
+}
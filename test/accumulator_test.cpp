@@ -0,0 +1,126 @@
+#include "accumulator.h"
+
+#include "catch.hpp"
+
+#include <cstdio>
+#include <string>
+
+TEST_CASE("accumulator averages per-pixel samples", "[accumulator]") {
+    Accumulator accumulator(2, 1);
+
+    accumulator.add(0, Color(1.f, 2.f, 3.f));
+    accumulator.add(0, Color(3.f, 4.f, 5.f));
+    accumulator.add(1, Color(1.f));
+
+    REQUIRE(accumulator.sampleCount(0) == 2);
+    REQUIRE(accumulator.sampleCount(1) == 1);
+    REQUIRE(accumulator.totalSamples() == 3);
+
+    const Color mean = accumulator.mean(0);
+    REQUIRE(mean.r() == Approx(2.f));
+    REQUIRE(mean.g() == Approx(3.f));
+    REQUIRE(mean.b() == Approx(4.f));
+}
+
+TEST_CASE("constant pixels converge and noisy pixels stay active", "[accumulator]") {
+    Accumulator accumulator(2, 1);
+
+    for (int i = 0; i < 16; i++) {
+        accumulator.add(0, Color(0.5f));
+        accumulator.add(1, Color(i % 2 == 0 ? 0.f : 1.f));
+    }
+
+    REQUIRE(accumulator.relativeError(0) == Approx(0.f));
+    REQUIRE(accumulator.relativeError(1) > 0.1f);
+
+    // Not enough samples yet to trust the estimate
+    REQUIRE(accumulator.updateConvergence(0.05f, 32) == 2);
+
+    REQUIRE(accumulator.updateConvergence(0.05f, 16) == 1);
+    REQUIRE(!accumulator.isActive(0));
+    REQUIRE(accumulator.isActive(1));
+    REQUIRE(accumulator.activeCount() == 1);
+}
+
+TEST_CASE("mean variance shrinks with the sample count", "[accumulator]") {
+    Accumulator accumulator(1, 1);
+
+    accumulator.add(0, Color(2.f));
+    REQUIRE(accumulator.meanVariance(0) == Approx(4.f));
+
+    accumulator.add(0, Color(0.f));
+    accumulator.add(0, Color(2.f));
+    accumulator.add(0, Color(0.f));
+
+    // Sample variance 4/3 over 4 samples
+    REQUIRE(accumulator.meanVariance(0) == Approx(1.f / 3.f));
+}
+
+TEST_CASE("splatted passes count every pixel", "[accumulator]") {
+    Accumulator accumulator(2, 2);
+
+    accumulator.splat(3, Color(2.f));
+    accumulator.splat(3, Color(2.f));
+    accumulator.addSplatPass();
+    accumulator.addSplatPass();
+
+    REQUIRE(accumulator.sampleCount(0) == 2);
+    REQUIRE(accumulator.mean(0).r() == Approx(0.f));
+    REQUIRE(accumulator.mean(3).r() == Approx(2.f));
+}
+
+TEST_CASE("checkpoints round-trip the raw accumulator", "[accumulator]") {
+    const std::string path = "accumulator_test.ckpt";
+
+    Accumulator accumulator(2, 1);
+    for (int i = 0; i < 16; i++) {
+        accumulator.add(0, Color(0.5f));
+        accumulator.add(1, Color(i % 2 == 0 ? 0.f : 1.f));
+    }
+    accumulator.updateConvergence(0.01f, 4);
+
+    REQUIRE(accumulator.saveCheckpoint(path, { 42, 7, 16 }));
+
+    Accumulator wrongJob(2, 1);
+    CheckpointInfo info;
+    REQUIRE(!wrongJob.loadCheckpoint(path, 43, &info));
+    REQUIRE(wrongJob.totalSamples() == 0);
+
+    Accumulator wrongSize(1, 2);
+    REQUIRE(!wrongSize.loadCheckpoint(path, 42, &info));
+
+    Accumulator resumed(2, 1);
+    REQUIRE(resumed.loadCheckpoint(path, 42, &info));
+    REQUIRE(info.seed == 7);
+    REQUIRE(info.passes == 16);
+
+    REQUIRE(resumed.totalSamples() == accumulator.totalSamples());
+    REQUIRE(resumed.mean(1).r() == Approx(accumulator.mean(1).r()));
+    REQUIRE(resumed.relativeError(1) == Approx(accumulator.relativeError(1)));
+    REQUIRE(!resumed.isActive(0));
+    REQUIRE(resumed.activeCount() == 1);
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("merged accumulators match a single render", "[accumulator]") {
+    Accumulator single(2, 1);
+    Accumulator first(2, 1);
+    Accumulator second(2, 1);
+
+    for (int i = 0; i < 12; i++) {
+        const Color color(0.1f * i, 0.2f, 0.05f * (i % 3));
+        single.add(0, color);
+        (i < 5 ? first : second).add(0, color);
+    }
+    second.add(1, Color(1.f));
+    single.add(1, Color(1.f));
+
+    first.merge(second);
+
+    REQUIRE(first.sampleCount(0) == 12);
+    REQUIRE(first.sampleCount(1) == 1);
+    REQUIRE(first.mean(0).r() == Approx(single.mean(0).r()));
+    REQUIRE(first.mean(1).g() == Approx(1.f));
+    REQUIRE(first.relativeError(0) == Approx(single.relativeError(0)));
+}
@@ -0,0 +1,88 @@
+#include "aov_buffer.h"
+
+#include "catch.hpp"
+
+#include <memory>
+
+class FlatMaterial : public Material {
+public:
+    FlatMaterial(Color albedo) : Material(Color(0.f)), m_albedo(albedo) {}
+
+    Color f(const Intersection &intersection, const Vector3 &wiWorld, float *pdf) const override {
+        *pdf = 0.f;
+        return Color(0.f);
+    }
+
+    BSDFSample sample(const Intersection &intersection, RandomGenerator &random) const override {
+        return BSDFSample({ Vector3(0.f), 0.f, Color(0.f), this });
+    }
+
+    Color albedo(const Intersection &intersection) const override { return m_albedo; }
+
+private:
+    Color m_albedo;
+};
+
+static Intersection hit(float t, Vector3 normal, Material *material)
+{
+    return Intersection(
+        true,
+        t,
+        Point3(0.f, 0.f, t),
+        Vector3(0.6f, 0.f, 0.8f),
+        normal,
+        normal,
+        { 0.f, 0.f },
+        material,
+        nullptr
+    );
+}
+
+TEST_CASE("albedo and normal average over every camera ray", "[aov_buffer]") {
+    FlatMaterial material(Color(0.5f, 0.25f, 1.f));
+
+    AOVBuffer aovs(2, 1);
+    aovs.add(1, hit(2.f, Vector3(0.f, 0.f, 1.f), &material));
+    aovs.add(1, IntersectionHelper::miss);
+
+    const Color albedo = aovs.albedo(1);
+    REQUIRE(albedo.r() == Approx(0.25f));
+    REQUIRE(albedo.g() == Approx(0.125f));
+    REQUIRE(albedo.b() == Approx(0.5f));
+
+    REQUIRE(aovs.normal(1).z() == Approx(0.5f));
+
+    // Misses have no depth
+    REQUIRE(aovs.depth(1) == Approx(2.f));
+
+    REQUIRE(aovs.albedo(0).r() == 0.f);
+    REQUIRE(aovs.depth(0) == 0.f);
+}
+
+TEST_CASE("material ID comes from the first hit", "[aov_buffer]") {
+    auto first = std::make_shared<FlatMaterial>(Color(1.f));
+    auto second = std::make_shared<FlatMaterial>(Color(1.f));
+    FlatMaterial unlisted(Color(1.f));
+
+    NestedSurfaceVector surfaces = {
+        { std::make_shared<Surface>(nullptr, first, nullptr) },
+        {
+            std::make_shared<Surface>(nullptr, second, nullptr),
+            std::make_shared<Surface>(nullptr, first, nullptr)
+        }
+    };
+
+    AOVBuffer aovs(3, 1);
+    aovs.assignMaterialIDs(surfaces);
+
+    aovs.add(0, hit(1.f, Vector3(0.f, 1.f, 0.f), second.get()));
+    aovs.add(0, hit(1.f, Vector3(0.f, 1.f, 0.f), first.get()));
+    REQUIRE(aovs.materialID(0) == 1);
+
+    aovs.add(1, IntersectionHelper::miss);
+    aovs.add(1, hit(1.f, Vector3(0.f, 1.f, 0.f), first.get()));
+    REQUIRE(aovs.materialID(1) == 0);
+
+    aovs.add(2, hit(1.f, Vector3(0.f, 1.f, 0.f), &unlisted));
+    REQUIRE(aovs.materialID(2) == -1);
+}
@@ -0,0 +1,64 @@
+#include "denoiser.h"
+
+#include "random_generator.h"
+
+#include "catch.hpp"
+
+#include <cmath>
+
+static const int Width = 32;
+static const int Height = 32;
+
+static float squaredError(const Denoiser &denoiser, int begin, int end, float expected)
+{
+    float error = 0.f;
+    for (int pixelIndex = begin; pixelIndex < end; pixelIndex++) {
+        const float difference = denoiser.output(pixelIndex).r() - expected;
+        error += difference * difference;
+    }
+    return error;
+}
+
+TEST_CASE("denoising flattens noise on a flat surface", "[denoiser]") {
+    RandomGenerator random(1, 0);
+
+    Denoiser noisy(Width, Height, 0);
+    Denoiser denoiser(Width, Height, 5);
+    for (int pixelIndex = 0; pixelIndex < Width * Height; pixelIndex++) {
+        const Color radiance(0.5f + 0.2f * (random.next() - 0.5f));
+        for (Denoiser *target : { &noisy, &denoiser }) {
+            target->setPixel(pixelIndex, radiance, 0.01f, Color(1.f), Vector3(0.f, 0.f, 1.f), 1.f);
+        }
+    }
+
+    noisy.denoise();
+    denoiser.denoise();
+
+    const float noisyError = squaredError(noisy, 0, Width * Height, 0.5f);
+    const float denoisedError = squaredError(denoiser, 0, Width * Height, 0.5f);
+    REQUIRE(denoisedError < 0.1f * noisyError);
+}
+
+TEST_CASE("denoising keeps geometric edges and albedo", "[denoiser]") {
+    Denoiser denoiser(Width, Height, 5);
+
+    // Top half faces the camera and is lit, bottom half is a dark wall with
+    // a textured albedo
+    for (int row = 0; row < Height; row++) {
+        for (int col = 0; col < Width; col++) {
+            const int pixelIndex = row * Width + col;
+            if (row < Height / 2) {
+                denoiser.setPixel(pixelIndex, Color(1.f), 0.01f, Color(1.f), Vector3(0.f, 0.f, 1.f), 1.f);
+            } else {
+                const Color albedo(col % 2 == 0 ? 0.2f : 0.8f);
+                denoiser.setPixel(pixelIndex, albedo * 0.1f, 0.01f, albedo, Vector3(1.f, 0.f, 0.f), 1.f);
+            }
+        }
+    }
+
+    denoiser.denoise();
+
+    REQUIRE(squaredError(denoiser, 0, Width * Height / 2, 1.f) == Approx(0.f).margin(1e-6f));
+    REQUIRE(denoiser.output((Height - 1) * Width + 0).r() == Approx(0.02f));
+    REQUIRE(denoiser.output((Height - 1) * Width + 1).r() == Approx(0.08f));
+}
@@ -0,0 +1,53 @@
+#include "image.h"
+
+#include "catch.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+TEST_CASE("readers only see published frames", "[image]") {
+    Image image(2, 2);
+    image.set(0, 0, 1.f, 2.f, 3.f);
+
+    const auto before = image.snapshot();
+    REQUIRE(before->raw[3 * 2 + 0] == 0.f);
+
+    image.setSpp(1);
+    image.publish();
+
+    const auto published = image.snapshot();
+    REQUIRE(published->spp == 1);
+
+    // Row 0 is stored last for EXR
+    REQUIRE(published->raw[3 * 2 + 0] == 1.f);
+    REQUIRE(published->raw[3 * 2 + 2] == 3.f);
+
+    // Held snapshots never change, and the next frame starts from this one
+    image.set(1, 1, 4.f, 4.f, 4.f);
+    image.publish();
+    REQUIRE(published->raw[3 * 1 + 0] == 0.f);
+    REQUIRE(image.snapshot()->raw[3 * 1 + 0] == 4.f);
+    REQUIRE(image.snapshot()->raw[3 * 2 + 0] == 1.f);
+}
+
+TEST_CASE("display bytes follow gamma 2.2", "[image]") {
+    const int width = 1024;
+    Image image(width, 1);
+
+    std::vector<float> values(width);
+    for (int col = 0; col < width; col++) {
+        values[col] = std::pow(col / (width - 1.f), 3.f) * 1.25f;
+        image.set(0, col, values[col], values[col], values[col]);
+    }
+    image.set(0, 0, -1.f, NAN, 0.f);
+    values[0] = 0.f;
+    image.publish();
+
+    const std::vector<unsigned char> bytes = image.data();
+    for (int col = 0; col < width; col++) {
+        const int expected = std::fmin(std::pow(values[col], 1 / 2.2f), 1.f) * 255;
+        REQUIRE(std::abs(bytes[3 * col + 0] - expected) <= 1);
+    }
+    REQUIRE(bytes[1] == 0);
+}
@@ -0,0 +1,79 @@
+#include "image_writer.h"
+
+#include "tinyexr.h"
+
+#include "catch.hpp"
+
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+
+static std::shared_ptr<ImageSnapshot> gradient(int width, int height, int spp)
+{
+    auto snapshot = std::make_shared<ImageSnapshot>();
+    snapshot->width = width;
+    snapshot->height = height;
+    snapshot->spp = spp;
+    snapshot->raw.resize(3 * width * height);
+    for (int i = 0; i < width * height; i++) {
+        snapshot->raw[3 * i + 0] = i;
+        snapshot->raw[3 * i + 1] = 0.5f;
+        snapshot->raw[3 * i + 2] = 0.25f;
+    }
+    return snapshot;
+}
+
+TEST_CASE("queued snapshots land on disk by flush", "[image_writer]") {
+    const std::string stem = "image_writer_test";
+    unlink((stem + ".exr").c_str());
+    unlink((stem + "-00008spp.exr").c_str());
+
+    auto snapshot = gradient(4, 3, 8);
+    {
+        ImageWriter writer("", 1, TINYEXR_COMPRESSIONTYPE_ZIP);
+        writer.save(snapshot, stem, true);
+
+        // Later changes to the render can't reach the queued copy
+        snapshot.reset();
+
+        writer.flush();
+
+        for (const std::string &path : { stem + ".exr", stem + "-00008spp.exr" }) {
+            float *rgba;
+            int width, height;
+            const char *err = nullptr;
+            REQUIRE(LoadEXR(&rgba, &width, &height, path.c_str(), &err) == TINYEXR_SUCCESS);
+            REQUIRE(width == 4);
+            REQUIRE(height == 3);
+            REQUIRE(rgba[4 * 5 + 0] == Approx(5.f));
+            REQUIRE(rgba[4 * 5 + 1] == Approx(0.5f));
+            REQUIRE(rgba[4 * 5 + 2] == Approx(0.25f));
+            free(rgba);
+        }
+
+        REQUIRE(access((stem + ".exr.tmp").c_str(), F_OK) != 0);
+    }
+
+    unlink((stem + ".exr").c_str());
+    unlink((stem + "-00008spp.exr").c_str());
+}
+
+TEST_CASE("destroying the writer finishes queued writes", "[image_writer]") {
+    const std::string stem = "image_writer_drain_test";
+
+    {
+        ImageWriter writer("", 2, TINYEXR_COMPRESSIONTYPE_NONE);
+        for (int spp = 1; spp <= 4; spp++) {
+            writer.save(gradient(8, 8, spp), stem, true);
+        }
+    }
+
+    for (int spp = 1; spp <= 4; spp++) {
+        const std::string path = stem + "-0000" + std::to_string(spp) + "spp.exr";
+        REQUIRE(access(path.c_str(), F_OK) == 0);
+        unlink(path.c_str());
+    }
+    unlink((stem + ".exr").c_str());
+}
@@ -0,0 +1,63 @@
+#include "job.h"
+
+#include "catch.hpp"
+
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <stdio.h>
+#include <string>
+
+static std::unique_ptr<Job> loadJob(const std::string &extraJson)
+{
+    const std::string path = "job_test.json";
+    {
+        std::ofstream jobFile(path);
+        jobFile << "{ \"width\": 8, \"height\": 6, \"startBounce\": 0, \"lastBounce\": 1"
+                << extraJson << " }";
+    }
+
+    std::ifstream jobFile(path);
+    auto job = std::make_unique<Job>(jobFile);
+    remove(path.c_str());
+
+    return job;
+}
+
+TEST_CASE("debug pixels count y down from the top row", "[job]") {
+    auto job = loadJob(", \"debug_pixels\": [[2, 0], [3, 5], [9, 1]]");
+
+    const std::vector<int> pixelIndices = job->debugPixels();
+    REQUIRE(pixelIndices.size() == 2);
+
+    // Pixel indices count rows up from the bottom
+    REQUIRE(pixelIndices[0] == 5 * 8 + 2);
+    REQUIRE(pixelIndices[1] == 0 * 8 + 3);
+}
+
+TEST_CASE("crop windows count y down from the top row", "[job]") {
+    auto job = loadJob(", \"crop\": [1, 1, 3, 2]");
+
+    // Top-down rows 1-2 of a 6 row image are bottom-up rows 3-4
+    const Tile window = job->cropWindow();
+    REQUIRE(window.startRow == 3);
+    REQUIRE(window.endRow == 5);
+    REQUIRE(window.startCol == 1);
+    REQUIRE(window.endCol == 4);
+}
+
+TEST_CASE("crop windows clip to the image", "[job]") {
+    auto job = loadJob(", \"crop\": [6, -2, 4, 3]");
+
+    const Tile window = job->cropWindow();
+    REQUIRE(window.startRow == 5);
+    REQUIRE(window.endRow == 6);
+    REQUIRE(window.startCol == 6);
+    REQUIRE(window.endCol == 8);
+}
+
+TEST_CASE("unknown samplers throw a runtime error", "[job]") {
+    auto job = loadJob(", \"sampler\": \"sobel\"");
+
+    REQUIRE_THROWS_AS(job->sampler(), std::runtime_error);
+}
@@ -0,0 +1,52 @@
+#include "random_generator.h"
+
+#include "catch.hpp"
+
+TEST_CASE("same seed and stream reproduce", "[random]") {
+    RandomGenerator a(1234, 7);
+    RandomGenerator b(1234, 7);
+
+    for (int i = 0; i < 100; i++) {
+        REQUIRE(a.nextUInt() == b.nextUInt());
+    }
+}
+
+TEST_CASE("reseeding restarts the stream", "[random]") {
+    RandomGenerator random(1234, 7);
+    const float first = random.next();
+    random.next();
+
+    random.reseed(1234, 7);
+    REQUIRE(random.next() == first);
+}
+
+TEST_CASE("streams and seeds diverge", "[random]") {
+    RandomGenerator base(1234, 7);
+    RandomGenerator otherStream(1234, 8);
+    RandomGenerator otherSeed(1235, 7);
+
+    int streamMatches = 0;
+    int seedMatches = 0;
+    for (int i = 0; i < 100; i++) {
+        const uint32_t value = base.nextUInt();
+        if (value == otherStream.nextUInt()) { streamMatches++; }
+        if (value == otherSeed.nextUInt()) { seedMatches++; }
+    }
+
+    REQUIRE(streamMatches == 0);
+    REQUIRE(seedMatches == 0);
+}
+
+TEST_CASE("floats stay in [0, 1)", "[random]") {
+    RandomGenerator random(42, 0);
+
+    float sum = 0.f;
+    for (int i = 0; i < 10000; i++) {
+        const float value = random.next();
+        REQUIRE(value >= 0.f);
+        REQUIRE(value < 1.f);
+        sum += value;
+    }
+
+    REQUIRE(sum / 10000 == Approx(0.5f).epsilon(0.02f));
+}
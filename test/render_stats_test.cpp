@@ -0,0 +1,49 @@
+#include "render_stats.h"
+
+#include "catch.hpp"
+
+#include <thread>
+
+TEST_CASE("counters from every thread are collected once", "[render_stats]") {
+    RenderStats::collect();
+
+    RenderStats::local().intersectRays += 3;
+    RenderStats::local().primaryRays += 1;
+
+    std::thread worker([] {
+        RenderStats::local().shadowRays += 2;
+        RenderStats::local().volumetricOcclusionRays += 1;
+    });
+    worker.join();
+
+    const RenderCounters counters = RenderStats::collect();
+    REQUIRE(counters.totalRays() == 6);
+    REQUIRE(counters.extensionRays() == 2);
+    REQUIRE(counters.volumetricRays() == 1);
+
+    REQUIRE(RenderStats::collect().totalRays() == 0);
+}
+
+TEST_CASE("long paths share the last histogram bucket", "[render_stats]") {
+    RenderCounters counters;
+    counters.recordPathLength(2);
+    counters.recordPathLength(RenderCounters::PathLengthBuckets + 10);
+
+    REQUIRE(counters.pathLengths[2] == 1);
+    REQUIRE(counters.pathLengths[RenderCounters::PathLengthBuckets - 1] == 1);
+
+    const nlohmann::json stats = counters.toJSON(0.0);
+    REQUIRE(stats["mrays_per_second"].get<double>() == 0.0);
+    REQUIRE(stats["primary_stage"]["mrays_per_thread_second"].get<double>() == 0.0);
+    REQUIRE(stats["path_lengths"].size() == RenderCounters::PathLengthBuckets);
+}
+
+TEST_CASE("primary stage throughput is per thread second", "[render_stats]") {
+    RenderCounters counters;
+    counters.primaryRays = 4000000;
+    counters.primaryNanoseconds = 2000000000;
+
+    const nlohmann::json stats = counters.toJSON(1.0);
+    REQUIRE(stats["primary_stage"]["thread_seconds"].get<double>() == Approx(2.0));
+    REQUIRE(stats["primary_stage"]["mrays_per_thread_second"].get<double>() == Approx(2.0));
+}
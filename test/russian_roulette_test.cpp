@@ -0,0 +1,62 @@
+#include "russian_roulette.h"
+
+#include "color.h"
+#include "random_generator.h"
+
+#include "catch.hpp"
+
+#include <algorithm>
+
+TEST_CASE("disabled roulette leaves paths alone", "[russian_roulette]") {
+    RussianRoulette roulette;
+    RandomGenerator random(1, 0);
+
+    float weight;
+    REQUIRE(roulette.evaluate(10, Color(1e-6f), random, &weight) == 1);
+    REQUIRE(weight == 1.f);
+}
+
+TEST_CASE("roulette waits for its start bounce", "[russian_roulette]") {
+    RussianRoulette roulette(3, 0.5f, 0.f, 1);
+    RandomGenerator random(1, 0);
+
+    float weight;
+    REQUIRE(roulette.evaluate(2, Color(1e-6f), random, &weight) == 1);
+    REQUIRE(weight == 1.f);
+}
+
+TEST_CASE("roulette is unbiased below the window", "[russian_roulette]") {
+    RussianRoulette roulette(0, 0.5f, 2.f, 4);
+    RandomGenerator random(1234, 0);
+
+    const Color throughput(0.1f);
+
+    const int trials = 200000;
+    double total = 0.0;
+    int maxCopies = 0;
+    for (int i = 0; i < trials; i++) {
+        float weight;
+        const int copies = roulette.evaluate(1, throughput, random, &weight);
+
+        total += copies * weight * throughput.luminance();
+        maxCopies = std::max(maxCopies, copies);
+    }
+
+    REQUIRE(maxCopies == 1);
+    REQUIRE(total / trials == Approx(throughput.luminance()).epsilon(0.02));
+}
+
+TEST_CASE("heavy paths split into lighter copies", "[russian_roulette]") {
+    RussianRoulette roulette(0, 0.5f, 2.f, 4);
+    RandomGenerator random(1, 0);
+
+    float weight;
+    REQUIRE(roulette.evaluate(1, Color(5.f), random, &weight) == 3);
+    REQUIRE(weight == Approx(1.f / 3.f));
+
+    REQUIRE(roulette.evaluate(1, Color(100.f), random, &weight) == 4);
+    REQUIRE(weight == Approx(0.25f));
+
+    REQUIRE(roulette.evaluate(1, Color(1.f), random, &weight) == 1);
+    REQUIRE(weight == 1.f);
+}
@@ -0,0 +1,127 @@
+#include "blue_noise_sampler.h"
+#include "halton_sampler.h"
+#include "sampler.h"
+#include "sobol_sampler.h"
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+static std::vector<std::array<float, 2> > draw2D(Sampler &sampler, int pixelIndex, int count)
+{
+    std::vector<std::array<float, 2> > points;
+    for (int i = 0; i < count; i++) {
+        sampler.startPixelSample(pixelIndex, i);
+        points.push_back(sampler.next2D());
+    }
+    return points;
+}
+
+static bool isStratified(const std::vector<std::array<float, 2> > &points, int strata)
+{
+    std::vector<int> cells(strata * strata, 0);
+    for (const auto &point : points) {
+        const int x = point[0] * strata;
+        const int y = point[1] * strata;
+        cells[y * strata + x] += 1;
+    }
+    return std::all_of(cells.begin(), cells.end(), [](int count) { return count == 1; });
+}
+
+TEST_CASE("sobol points are stratified per pixel", "[sampler]") {
+    SobolSampler sampler(1234);
+
+    for (int pixelIndex = 0; pixelIndex < 8; pixelIndex++) {
+        REQUIRE(isStratified(draw2D(sampler, pixelIndex, 16), 4));
+    }
+}
+
+TEST_CASE("sobol dimensions are padded and reproducible", "[sampler]") {
+    SobolSampler a(1234);
+    SobolSampler b(1234);
+
+    a.startPixelSample(17, 5);
+    b.startPixelSample(17, 5);
+    for (int i = 0; i < 32; i++) {
+        const float value = a.next();
+        REQUIRE(value == b.next());
+        REQUIRE(value >= 0.f);
+        REQUIRE(value < 1.f);
+    }
+    REQUIRE(a.dimension() == 32);
+
+    std::vector<int> strata(8, 0);
+    for (int i = 0; i < 8; i++) {
+        a.startPixelSample(17, i);
+        a.next();
+        strata[(int)(a.next() * 8)] += 1;
+    }
+    REQUIRE(std::all_of(strata.begin(), strata.end(), [](int count) { return count == 1; }));
+}
+
+TEST_CASE("halton dimensions are stratified in their base", "[sampler]") {
+    HaltonSampler sampler(1234);
+
+    std::vector<int> base2(4, 0);
+    std::vector<int> base3(9, 0);
+    for (int i = 0; i < 36; i++) {
+        sampler.startPixelSample(3, i);
+        const float xi2 = sampler.next();
+        const float xi3 = sampler.next();
+        if (i < 4) { base2[(int)(xi2 * 4)] += 1; }
+        if (i < 9) { base3[(int)(xi3 * 9)] += 1; }
+    }
+
+    REQUIRE(std::all_of(base2.begin(), base2.end(), [](int count) { return count == 1; }));
+    REQUIRE(std::all_of(base3.begin(), base3.end(), [](int count) { return count == 1; }));
+}
+
+TEST_CASE("blue noise mask is a full ranking", "[sampler]") {
+    std::vector<float> mask = BlueNoiseSampler::mask();
+    REQUIRE(mask.size() == BlueNoiseSampler::MaskSize * BlueNoiseSampler::MaskSize);
+
+    std::sort(mask.begin(), mask.end());
+    for (int i = 0; i < mask.size(); i++) {
+        REQUIRE(mask[i] == Approx((i + 0.5f) / mask.size()));
+    }
+}
+
+TEST_CASE("blue noise samples stay stratified per pixel", "[sampler]") {
+    BlueNoiseSampler sampler(1234, 64);
+
+    // Toroidal rotation keeps a 1D stratification of the shared sequence
+    for (int pixelIndex = 0; pixelIndex < 4; pixelIndex++) {
+        std::vector<int> strata(8, 0);
+        for (int i = 0; i < 8; i++) {
+            sampler.startPixelSample(pixelIndex, i);
+            const float value = sampler.next();
+            REQUIRE(value >= 0.f);
+            REQUIRE(value < 1.f);
+            strata[(int)(value * 8)] += 1;
+        }
+        REQUIRE(*std::max_element(strata.begin(), strata.end()) <= 2);
+    }
+}
+
+TEST_CASE("resumed pixel samples continue the same sequence", "[sampler]") {
+    Sampler independent(1234);
+    SobolSampler sobol(1234);
+    HaltonSampler halton(1234);
+
+    for (Sampler *sampler : std::vector<Sampler *>({ &independent, &sobol, &halton })) {
+        sampler->startPixelSample(9, 3);
+        for (int i = 0; i < 70; i++) {
+            sampler->next();
+        }
+        const int dimension = sampler->dimension();
+        const float expected = sampler->next();
+
+        sampler->startPixelSample(0, 0);
+        sampler->next();
+
+        sampler->resumePixelSample(9, 3, dimension);
+        REQUIRE(sampler->next() == expected);
+    }
+}
@@ -0,0 +1,41 @@
+#include "shading_frame.h"
+
+#include "transform.h"
+#include "vector.h"
+#include "catch.hpp"
+
+TEST_CASE("shading frame matches normalToWorldSpace", "[shading_frame]") {
+    const Vector3 normal = Vector3(1, 2, 3).normalized();
+    const Vector3 wo = Vector3(0.6f, 0.f, 0.8f);
+
+    const ShadingFrame frame(normal, wo);
+    const Transform transform = normalToWorldSpace(normal, wo);
+
+    const Vector3 local = Vector3(0.3f, -0.5f, 0.8f);
+    const Vector3 expected = transform.apply(local);
+    const Vector3 world = frame.toWorld(local);
+
+    REQUIRE(world.x() == Approx(expected.x()));
+    REQUIRE(world.y() == Approx(expected.y()));
+    REQUIRE(world.z() == Approx(expected.z()));
+}
+
+TEST_CASE("shading frame round trips", "[shading_frame]") {
+    const Vector3 normal = Vector3(-2, 1, 0.5f).normalized();
+
+    // wo along the normal takes the fallback tangent
+    for (const Vector3 &wo : { Vector3(0.f, 0.f, 1.f), normal }) {
+        const ShadingFrame frame(normal, wo);
+
+        const Vector3 localNormal = frame.toLocal(normal);
+        REQUIRE(localNormal.x() == Approx(0.f).margin(1e-6));
+        REQUIRE(localNormal.y() == Approx(1.f));
+        REQUIRE(localNormal.z() == Approx(0.f).margin(1e-6));
+
+        const Vector3 world = Vector3(0.1f, 0.7f, -0.4f);
+        const Vector3 roundTrip = frame.toWorld(frame.toLocal(world));
+        REQUIRE(roundTrip.x() == Approx(world.x()));
+        REQUIRE(roundTrip.y() == Approx(world.y()));
+        REQUIRE(roundTrip.z() == Approx(world.z()));
+    }
+}
@@ -0,0 +1,91 @@
+#include "tile_scheduler.h"
+
+#include "catch.hpp"
+
+#include <vector>
+
+TEST_CASE("tiles cover the frame exactly once", "[tile_scheduler]") {
+    TileScheduler scheduler(37, 21, 8);
+    REQUIRE(scheduler.tileCount() == 5 * 3);
+
+    std::vector<int> coverage(37 * 21, 0);
+    for (int i = 0; i < scheduler.tileCount(); i++) {
+        const Tile &tile = scheduler.tile(i);
+        for (int row = tile.startRow; row < tile.endRow; row++) {
+            for (int col = tile.startCol; col < tile.endCol; col++) {
+                coverage[row * 37 + col] += 1;
+            }
+        }
+    }
+
+    for (int count : coverage) {
+        REQUIRE(count == 1);
+    }
+}
+
+TEST_CASE("tiles follow a Morton curve", "[tile_scheduler]") {
+    TileScheduler scheduler(32, 32, 8);
+
+    REQUIRE(scheduler.tile(0).startCol == 0);
+    REQUIRE(scheduler.tile(0).startRow == 0);
+    REQUIRE(scheduler.tile(1).startCol == 8);
+    REQUIRE(scheduler.tile(1).startRow == 0);
+    REQUIRE(scheduler.tile(2).startCol == 0);
+    REQUIRE(scheduler.tile(2).startRow == 8);
+    REQUIRE(scheduler.tile(3).startCol == 8);
+    REQUIRE(scheduler.tile(3).startRow == 8);
+    REQUIRE(scheduler.tile(4).startCol == 16);
+    REQUIRE(scheduler.tile(4).startRow == 0);
+}
+
+TEST_CASE("idle workers steal remaining tiles", "[tile_scheduler]") {
+    TileScheduler scheduler(64, 64, 16);
+    scheduler.reset(4);
+
+    std::vector<int> visits(scheduler.tileCount(), 0);
+
+    // Worker 0 drains its own range and then everyone else's
+    int tileIndex;
+    int taken = 0;
+    while (scheduler.next(0, &tileIndex)) {
+        visits[tileIndex] += 1;
+        scheduler.recordTime(0, tileIndex, 1.0);
+        taken += 1;
+    }
+
+    REQUIRE(taken == scheduler.tileCount());
+    for (int count : visits) {
+        REQUIRE(count == 1);
+    }
+
+    REQUIRE(!scheduler.next(1, &tileIndex));
+
+    const TileStats stats = scheduler.stats();
+    REQUIRE(stats.stealCount == 12);
+    REQUIRE(stats.maxWorkerSeconds == Approx(16.0));
+    REQUIRE(stats.imbalance() == Approx(4.0));
+}
+
+TEST_CASE("region tiles cover only the region", "[tile_scheduler]") {
+    const Tile region = { 5, 25, 10, 19 };
+    TileScheduler scheduler(region, 8);
+    REQUIRE(scheduler.tileCount() == 2 * 3);
+
+    std::vector<int> coverage(32 * 32, 0);
+    for (int i = 0; i < scheduler.tileCount(); i++) {
+        const Tile &tile = scheduler.tile(i);
+        for (int row = tile.startRow; row < tile.endRow; row++) {
+            for (int col = tile.startCol; col < tile.endCol; col++) {
+                coverage[row * 32 + col] += 1;
+            }
+        }
+    }
+
+    for (int row = 0; row < 32; row++) {
+        for (int col = 0; col < 32; col++) {
+            const bool inside = row >= region.startRow && row < region.endRow
+                && col >= region.startCol && col < region.endCol;
+            REQUIRE(coverage[row * 32 + col] == (inside ? 1 : 0));
+        }
+    }
+}
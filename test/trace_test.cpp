@@ -0,0 +1,37 @@
+#include "trace.h"
+
+#include "catch.hpp"
+#include "json.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+TEST_CASE("scopes are written as complete trace events", "[trace]") {
+    {
+        Trace::Scope outer("outer");
+        Trace::Scope inner("inner", "detail");
+    }
+
+    const std::string path = "trace_test.json";
+    Trace::write(path);
+
+    std::ifstream traceFile(path);
+    const nlohmann::json trace = nlohmann::json::parse(traceFile);
+    std::remove(path.c_str());
+
+    const nlohmann::json &events = trace["traceEvents"];
+    REQUIRE(events.size() >= 2);
+
+    // Inner closes first
+    const nlohmann::json &inner = events[events.size() - 2];
+    const nlohmann::json &outer = events[events.size() - 1];
+    REQUIRE(inner["name"] == "inner");
+    REQUIRE(inner["ph"] == "X");
+    REQUIRE(inner["args"]["detail"] == "detail");
+    REQUIRE(outer["name"] == "outer");
+    REQUIRE(outer.count("args") == 0);
+
+    REQUIRE(outer["ts"].get<int64_t>() <= inner["ts"].get<int64_t>());
+    REQUIRE(outer["dur"].get<int64_t>() >= inner["dur"].get<int64_t>());
+}
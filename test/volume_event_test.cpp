@@ -0,0 +1,48 @@
+#include "volume_event.h"
+
+#include "catch.hpp"
+
+TEST_CASE("volume events stay sorted by t", "[volume_event]") {
+    VolumeEventList events;
+    REQUIRE(events.empty());
+
+    events.insert({ 3.f, nullptr });
+    events.insert({ 1.f, nullptr });
+    events.insert({ 2.f, nullptr });
+
+    REQUIRE(events.size() == 3);
+    REQUIRE(events[0].t == 1.f);
+    REQUIRE(events[1].t == 2.f);
+    REQUIRE(events[2].t == 3.f);
+}
+
+TEST_CASE("duplicate volume events are dropped", "[volume_event]") {
+    VolumeEventList events;
+    events.insert({ 1.f, nullptr });
+    events.insert({ 1.f, nullptr });
+
+    REQUIRE(events.size() == 1);
+}
+
+TEST_CASE("full volume event lists keep the nearest events", "[volume_event]") {
+    const int capacity = VolumeEventList::Capacity;
+
+    VolumeEventList events;
+    for (int i = capacity; i > 0; i--) {
+        events.insert({ (float)i, nullptr });
+    }
+    REQUIRE(events.size() == capacity);
+
+    events.insert({ 100.f, nullptr });
+    events.insert({ 0.5f, nullptr });
+
+    REQUIRE(events.size() == capacity);
+    REQUIRE(events[0].t == 0.5f);
+    REQUIRE(events[capacity - 1].t == (float)(capacity - 1));
+
+    float previous = 0.f;
+    for (const VolumeEvent &event : events) {
+        REQUIRE(event.t > previous);
+        previous = event.t;
+    }
+}
@@ -0,0 +1,111 @@
+#include "work_queue.h"
+
+#include "catch.hpp"
+
+#include <set>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static void removeQueue(const std::string &directory, int itemCount)
+{
+    char name[16];
+    for (const char *state : { "pending", "claimed", "done" }) {
+        for (int item = 0; item < itemCount; item++) {
+            snprintf(name, sizeof(name), "/%05d", item);
+            unlink((directory + "/" + state + name).c_str());
+        }
+        rmdir((directory + "/" + state).c_str());
+    }
+    unlink((directory + "/job").c_str());
+    rmdir(directory.c_str());
+}
+
+TEST_CASE("racing workers claim every item exactly once", "[work_queue]") {
+    const std::string directory = "work_queue_test";
+    const int itemCount = 64;
+    removeQueue(directory, itemCount);
+
+    // Catch assertions aren't thread safe, so workers record their results
+    // and the checks run after the join
+    std::vector<std::vector<int> > claims(4);
+    std::vector<int> created(4, false);
+    std::vector<std::thread> workers;
+    for (int worker = 0; worker < 4; worker++) {
+        workers.emplace_back([&, worker] {
+            const std::string workerName = "worker" + std::to_string(worker);
+
+            WorkQueue queue(directory);
+            created[worker] = queue.create(itemCount, 1, workerName);
+            if (!created[worker]) { return; }
+
+            int item;
+            while (queue.claim(workerName, &item)) {
+                claims[worker].push_back(item);
+                queue.complete(item);
+            }
+        });
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    for (int workerCreated : created) {
+        REQUIRE(workerCreated);
+    }
+
+    std::set<int> claimed;
+    int claimCount = 0;
+    for (const std::vector<int> &workerClaims : claims) {
+        claimed.insert(workerClaims.begin(), workerClaims.end());
+        claimCount += workerClaims.size();
+    }
+
+    REQUIRE(claimCount == itemCount);
+    REQUIRE(claimed.size() == itemCount);
+
+    WorkQueue queue(directory);
+    REQUIRE(queue.pendingCount() == 0);
+    REQUIRE(queue.doneCount() == itemCount);
+
+    removeQueue(directory, itemCount);
+}
+
+TEST_CASE("queues left by another job are rebuilt", "[work_queue]") {
+    const std::string directory = "work_queue_stale_test";
+    const int itemCount = 4;
+    removeQueue(directory, itemCount);
+
+    WorkQueue queue(directory);
+    REQUIRE(queue.create(itemCount, 1, "worker"));
+
+    int item;
+    while (queue.claim("worker", &item)) {
+        queue.complete(item);
+    }
+    REQUIRE(queue.doneCount() == itemCount);
+
+    // Same job joins the finished queue
+    REQUIRE(queue.create(itemCount, 1, "worker"));
+    REQUIRE(queue.pendingCount() == 0);
+
+    // A different job starts over
+    REQUIRE(queue.create(itemCount, 2, "worker"));
+    REQUIRE(queue.pendingCount() == itemCount);
+    REQUIRE(queue.doneCount() == 0);
+
+    REQUIRE(queue.claim("worker", &item));
+    REQUIRE(queue.create(itemCount, 2, "worker"));
+    REQUIRE(queue.pendingCount() == itemCount - 1);
+
+    removeQueue(directory, itemCount);
+}
+
+TEST_CASE("claims on a missing queue give up", "[work_queue]") {
+    WorkQueue queue("work_queue_missing_test");
+
+    int item;
+    REQUIRE(!queue.claim("worker", &item));
+}